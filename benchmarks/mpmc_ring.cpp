@@ -0,0 +1,80 @@
+// Throughput of tombstone_mpmc_ring with 1 to 64 threads, half of them producers and half consumers
+// (one of each for a single thread), in values popped per second.
+// usage: mpmc_ring_benchmark [operations per run]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <thread>
+#include <vector>
+#include <zxshady/mpmc_ring.hpp>
+
+namespace {
+using Traits = zxshady::tombstone_max_traits<std::uint64_t>;
+
+template<bool Padded>
+double Run(int threads, std::uint64_t operations, std::size_t batch)
+{
+  zxshady::tombstone_mpmc_ring<std::uint64_t, Traits, Padded> ring(1024);
+
+  const int           producers    = std::max(1, threads / 2);
+  const int           consumers    = std::max(1, threads - producers);
+  const std::uint64_t per_producer = operations / static_cast<std::uint64_t>(producers);
+  const std::uint64_t total        = per_producer * static_cast<std::uint64_t>(producers);
+
+  std::atomic<bool>          start{false};
+  std::atomic<std::uint64_t> popped{0};
+  std::vector<std::thread>   workers;
+
+  for (int p = 0; p < producers; ++p) {
+    workers.emplace_back([&] {
+      std::vector<std::uint64_t> values(batch, 1);
+      while (!start.load(std::memory_order_acquire)) {}
+      for (std::uint64_t left = per_producer; left != 0;) {
+        const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(batch, left));
+        left -= ring.try_push_n(std::span<const std::uint64_t>(values.data(), count));
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    workers.emplace_back([&] {
+      std::vector<std::uint64_t> out(batch);
+      while (!start.load(std::memory_order_acquire)) {}
+      // an idle consumer only reads `popped` and backs off, writing it would measure that cache line instead
+      for (int idle = 0; popped.load(std::memory_order_relaxed) < total;) {
+        const std::size_t count = ring.try_pop_n(out);
+        if (count != 0) {
+          popped.fetch_add(count, std::memory_order_relaxed);
+          idle = 0;
+        }
+        else if (++idle >= 16)
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto& worker : workers)
+    worker.join();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+  return static_cast<double>(total) / elapsed.count();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  const std::uint64_t operations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1u << 22;
+
+  std::printf("%8s %6s %16s %16s\n", "threads", "batch", "padded ops/s", "packed ops/s");
+  for (int threads = 1; threads <= 64; threads *= 2) {
+    for (const std::size_t batch : {std::size_t{1}, std::size_t{16}}) {
+      const double padded = Run<true>(threads, operations, batch);
+      const double packed = Run<false>(threads, operations, batch);
+      std::printf("%8d %6zu %16.0f %16.0f\n", threads, batch, padded, packed);
+    }
+  }
+}
@@ -0,0 +1,103 @@
+#include "interface.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <zxshady/array.hpp>
+#include <zxshady/handle_traits.hpp>
+
+namespace {
+using Traits = zxshady::tombstone_min_traits<std::int32_t>;
+
+template<std::size_t N>
+using Array = zxshady::tombstone_array<std::int32_t, N, Traits>;
+
+template<std::size_t N>
+constexpr std::size_t FillAndErase()
+{
+  Array<N> a;
+  for (std::int32_t i = 0; i < static_cast<std::int32_t>(N); ++i)
+    a.insert(i);
+  for (std::size_t i = 0; i < N; i += 3)
+    a.reset(i);
+  std::size_t sum = 0;
+  for (const std::int32_t x : a.present())
+    sum += static_cast<std::size_t>(x);
+  return sum + a.first_free() * 1000;
+}
+
+template<std::size_t N>
+void CheckScans()
+{
+  Array<N>                 a;
+  std::vector<std::size_t> slots;
+  REQUIRE(a.first_free() == 0);
+  REQUIRE(a.next_present(0) == N);
+
+  for (std::size_t i = 0; i < N; ++i)
+    REQUIRE(a.insert(static_cast<std::int32_t>(i)) == i);
+  REQUIRE(a.full());
+  REQUIRE(a.first_free() == N);
+  REQUIRE(a.insert(0) == N);
+
+  for (std::size_t i = 0; i < N; ++i)
+    if (i % 5 != 1)
+      REQUIRE(a.reset(i));
+  REQUIRE(!a.reset(0));
+  REQUIRE(a.size() == (N + 3) / 5);
+  REQUIRE(a.first_free() == 0);
+
+  for (auto it = a.present().begin(); it != a.present().end(); ++it) {
+    REQUIRE(it.index() % 5 == 1);
+    REQUIRE(*it == static_cast<std::int32_t>(it.index()));
+    slots.push_back(it.index());
+  }
+  REQUIRE(slots.size() == a.size());
+  for (std::size_t i = 0; i < N; ++i) {
+    std::size_t expected = i;
+    while (expected < N && expected % 5 != 1)
+      ++expected;
+    REQUIRE(a.next_present(i) == std::min(expected, N));
+  }
+
+  a.emplace(0, 7);
+  REQUIRE(a.value(0) == 7);
+  REQUIRE(a.first_free() == 2);
+  a.clear();
+  REQUIRE(a.empty());
+  REQUIRE(a.next_present(0) == N);
+  REQUIRE(!a[1]);
+}
+} // namespace
+
+TEST_CASE("tombstone_array", "[array]")
+{
+  STATIC_REQUIRE(Array<64>::uses_bitmap);
+  STATIC_REQUIRE(!Array<65>::uses_bitmap);
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Array<64>>);
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Array<300>>);
+  STATIC_REQUIRE(sizeof(Array<300>) == 300 * sizeof(std::int32_t) + sizeof(std::size_t));
+  STATIC_REQUIRE(!std::is_trivially_copyable_v<zxshady::tombstone_array<std::unique_ptr<int>, 4>>);
+
+  SECTION("Constexpr")
+  {
+    STATIC_REQUIRE(FillAndErase<10>() == 1 + 2 + 4 + 5 + 7 + 8);
+    STATIC_REQUIRE(FillAndErase<100>() == 3267);
+  }
+
+  SECTION("Bitmap scans") { CheckScans<64>(); }
+  SECTION("Small array") { CheckScans<7>(); }
+  SECTION("Presence scans") { CheckScans<300>(); }
+
+  SECTION("Non trivial values")
+  {
+    zxshady::tombstone_array<std::unique_ptr<int>, 100> a;
+    for (int i = 0; i < 100; ++i)
+      a.insert(std::make_unique<int>(i));
+    a.reset(42);
+    REQUIRE(a.first_free() == 42);
+    REQUIRE(a.insert(std::make_unique<int>(-1)) == 42);
+    REQUIRE(*a.value(42) == -1);
+  }
+}
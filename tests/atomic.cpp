@@ -0,0 +1,103 @@
+#include "interface.hpp"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <zxshady/atomic.hpp>
+
+namespace {
+using Traits = zxshady::tombstone_max_traits<std::uint64_t>;
+using Slot   = zxshady::atomic_tombstone_optional<std::uint64_t, Traits>;
+using Opt    = zxshady::tombstone_optional<std::uint64_t, Traits>;
+} // namespace
+
+TEST_CASE("atomic_tombstone_optional", "[atomic]")
+{
+  STATIC_REQUIRE(sizeof(Slot) == sizeof(std::uint64_t));
+  STATIC_REQUIRE(Slot::is_always_lock_free);
+
+  SECTION("Single thread")
+  {
+    Slot slot;
+    REQUIRE(!slot.has_value());
+    REQUIRE(!slot.take());
+    REQUIRE(!slot.try_publish(std::numeric_limits<std::uint64_t>::max()));
+    REQUIRE(!slot.has_value());
+
+    REQUIRE(slot.try_publish(1));
+    REQUIRE(!slot.try_publish(2));
+    REQUIRE(*slot.load() == 1);
+
+    REQUIRE(*slot.exchange(Opt(3)) == 1);
+    REQUIRE(*slot.take() == 3);
+    REQUIRE(!slot.has_value());
+
+    slot.store(Opt(4));
+    Opt expected = std::nullopt;
+    REQUIRE(!slot.compare_exchange_strong(expected, Opt(5)));
+    REQUIRE(*expected == 4);
+    REQUIRE(slot.compare_exchange_strong(expected, std::nullopt));
+    REQUIRE(!slot.has_value());
+
+    expected = std::nullopt;
+    while (!slot.compare_exchange_weak(expected, Opt(6), std::memory_order_acq_rel)) {}
+    REQUIRE(*slot.load(std::memory_order_acquire) == 6);
+
+    int                                      x = 0;
+    zxshady::atomic_tombstone_optional<int*> pointer;
+    REQUIRE(pointer.try_publish(&x));
+    REQUIRE(*pointer.take() == &x);
+  }
+
+  SECTION("Every published value is taken once")
+  {
+    constexpr std::uint64_t    per_thread = 5000;
+    Slot                       mailbox;
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> taken{0};
+
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 0; t < 2; ++t) {
+      threads.emplace_back([&, t] {
+        for (std::uint64_t i = 0; i < per_thread; ++i) {
+          const std::uint64_t value = t * per_thread + i;
+          while (!mailbox.try_publish(value))
+            std::this_thread::yield();
+          mailbox.notify_all();
+        }
+      });
+    }
+    for (int t = 0; t < 2; ++t) {
+      threads.emplace_back([&] {
+        while (taken.load() < 2 * per_thread) {
+          if (const Opt o = mailbox.take()) {
+            sum += *o;
+            ++taken;
+          }
+          else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    REQUIRE(taken.load() == 2 * per_thread);
+    REQUIRE(sum.load() == (2 * per_thread) * (2 * per_thread - 1) / 2);
+  }
+
+  SECTION("Waiting")
+  {
+    Slot        slot;
+    std::thread producer([&] {
+      slot.store(Opt(42), std::memory_order_release);
+      slot.notify_all();
+      slot.wait_until_empty(std::memory_order_acquire);
+    });
+    REQUIRE(*slot.wait_until_present(std::memory_order_acquire) == 42);
+    REQUIRE(*slot.take() == 42);
+    slot.notify_all();
+    producer.join();
+  }
+}
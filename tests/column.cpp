@@ -0,0 +1,179 @@
+#include "interface.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <zxshady/column.hpp>
+#include <zxshady/container_traits.hpp>
+
+namespace {
+using Column = zxshady::tombstone_column<std::int32_t, zxshady::tombstone_min_traits<std::int32_t>>;
+
+// the move constructor can throw and copying throws once `fail_copy` is set
+struct ThrowingMove {
+  static inline bool fail_copy = false;
+
+  int value;
+
+  explicit ThrowingMove(int v) noexcept : value(v) {}
+  ThrowingMove(ThrowingMove&& that) noexcept(false) : value(that.value) {}
+  ThrowingMove(const ThrowingMove& that) : value(that.value)
+  {
+    if (fail_copy)
+      throw std::runtime_error("copy");
+  }
+};
+
+struct ThrowingMoveTraits {
+  static void initialize_null_state(ThrowingMove& x) noexcept { std::construct_at(&x, -1); }
+  static bool is_null(const ThrowingMove& x) noexcept { return x.value == -1; }
+};
+} // namespace
+
+TEST_CASE("tombstone_column", "[column]")
+{
+  SECTION("Push back values and nulls")
+  {
+    Column c;
+    for (std::int32_t i = 0; i < 1000; ++i) {
+      if (i % 4 == 0)
+        c.push_back_null();
+      else
+        c.push_back(i);
+    }
+    REQUIRE(c.size() == 1000);
+    REQUIRE(c.size_present() == 750);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(c.data()) % 64 == 0);
+    REQUIRE(!c[0]);
+    REQUIRE(*c[1] == 1);
+
+    std::int64_t sum = 0;
+    for (const std::int32_t x : c.present()) {
+      REQUIRE(x % 4 != 0);
+      sum += x;
+    }
+    std::int64_t expected = 0;
+    for (std::int32_t i = 0; i < 1000; ++i)
+      if (i % 4 != 0)
+        expected += i;
+    REQUIRE(sum == expected);
+
+    c.push_back_null(10);
+    REQUIRE(c.size() == 1010);
+    REQUIRE(c.size_present() == 750);
+  }
+
+  SECTION("Bulk append")
+  {
+    std::vector<std::int32_t> values(100);
+    std::iota(values.begin(), values.end(), 1);
+
+    Column c;
+    c.push_back_null();
+    c.append(std::span<const std::int32_t>(values));
+    REQUIRE(c.size() == 101);
+    REQUIRE(c.size_present() == 100);
+    REQUIRE(*c[100] == 100);
+
+    Column copy = c;
+    copy.append(std::span<const Column::optional_type>(c.data(), c.size()));
+    REQUIRE(copy.size() == 202);
+    REQUIRE(!copy[101]);
+    REQUIRE(copy.size_present() == 200);
+
+    c.assign(std::span<const std::int32_t>(values.data(), 3));
+    REQUIRE(c.size() == 3);
+    REQUIRE(std::ranges::equal(c.present(), std::vector<std::int32_t>{1, 2, 3}));
+  }
+
+  SECTION("Non trivial values")
+  {
+    zxshady::tombstone_column<std::string> c;
+    c.push_back(std::string(100, 'a'));
+    c.push_back_null();
+    c.emplace_back(3, 'b');
+    const std::string values[] = {"x", "y"};
+    c.append(std::span<const std::string>(values));
+    REQUIRE(c.size() == 5);
+    REQUIRE(c.size_present() == 4);
+    REQUIRE(std::ranges::distance(c.present()) == 4);
+    REQUIRE(*c[2] == "bbb");
+
+    zxshady::tombstone_column<std::string> moved = std::move(c);
+    REQUIRE(moved.size() == 5);
+    moved.pop_back();
+    moved.clear();
+    REQUIRE(moved.empty());
+  }
+
+  SECTION("Arguments that point into the column while growing")
+  {
+    const std::string                           text(100, 'x');
+    zxshady::tombstone_column<std::string_view> c;
+    c.push_back(std::string_view(text));
+    while (c.size() != c.capacity())
+      c.push_back_null();
+    const std::size_t full = c.size();
+    c.emplace_back(**c.begin());
+    REQUIRE(c.size() == full + 1);
+    REQUIRE(*c[full] == text);
+
+    while (c.size() != c.capacity())
+      c.push_back(std::string_view(text).substr(c.size() % 10));
+    const std::vector<zxshady::tombstone_optional<std::string_view>> before(c.begin(), c.end());
+    c.append(std::span(c.data(), c.size()));
+    REQUIRE(c.size() == 2 * before.size());
+    for (std::size_t i = 0; i < c.size(); ++i) {
+      REQUIRE(c[i].has_value() == before[i % before.size()].has_value());
+      REQUIRE(c[i].value_or(std::string_view()) == before[i % before.size()].value_or(std::string_view()));
+    }
+
+    zxshady::tombstone_column<std::string> strings;
+    strings.push_back(std::string(100, 'a'));
+    strings.append(std::span<const std::string>(&*strings[0], 1));
+    REQUIRE(strings.size() == 2);
+    REQUIRE(*strings[1] == std::string(100, 'a'));
+  }
+}
+
+TEST_CASE("tombstone_column keeps its elements when growing fails", "[column]")
+{
+  zxshady::tombstone_column<ThrowingMove, ThrowingMoveTraits> c;
+  c.emplace_back(0);
+  c.push_back_null();
+  c.emplace_back(2);
+  while (c.size() != c.capacity())
+    c.push_back_null();
+  const std::size_t full = c.size();
+
+  ThrowingMove::fail_copy = true;
+  REQUIRE_THROWS_AS(c.emplace_back(3), std::runtime_error);
+  const ThrowingMove more[] = {ThrowingMove(4), ThrowingMove(5)};
+  REQUIRE_THROWS_AS(c.append(std::span<const ThrowingMove>(more)), std::runtime_error);
+  ThrowingMove::fail_copy = false;
+
+  REQUIRE(c.size() == full);
+  REQUIRE(c[0]->value == 0);
+  REQUIRE(!c[1]);
+  REQUIRE(c[2]->value == 2);
+
+  c.emplace_back(3);
+  REQUIRE(c.size() == full + 1);
+  REQUIRE(c[full]->value == 3);
+}
+
+TEST_CASE("tombstone_column rejects sizes past max_size", "[column]")
+{
+  Column c;
+  c.push_back(1);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(c.data()) % Column::alignment == 0);
+  REQUIRE_THROWS_AS(c.reserve(c.max_size() + 1), std::length_error);
+  REQUIRE_THROWS_AS(c.push_back_null(c.max_size()), std::length_error);
+  REQUIRE_THROWS_AS(c.push_back_null(SIZE_MAX), std::length_error);
+  REQUIRE(c.size() == 1);
+  REQUIRE(*c[0] == 1);
+}
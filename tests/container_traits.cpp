@@ -0,0 +1,86 @@
+#include "interface.hpp"
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <zxshady/container_traits.hpp>
+
+TEST_CASE("string_view traits", "[container_traits][string_view]")
+{
+  using Opt = zxshady::tombstone_optional<std::string_view>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(std::string_view));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Opt>);
+
+  constexpr Opt a;
+  constexpr Opt b = std::string_view{"\0\0", 2};
+  STATIC_REQUIRE(!a);
+  STATIC_REQUIRE(b);
+
+  const Opt empty = std::string_view{};
+  REQUIRE(empty);
+
+  Opt o = "Hello";
+  REQUIRE(o == "Hello");
+  o.reset();
+  REQUIRE(!o);
+}
+
+TEST_CASE("span traits", "[container_traits][span]")
+{
+  using Opt = zxshady::tombstone_optional<std::span<const int>>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(std::span<const int>));
+
+  const std::vector<int> v = {1, 2, 3};
+  Opt                    o;
+  REQUIRE(!o);
+  o = std::span<const int>(v);
+  REQUIRE(o->size() == 3);
+  o = std::span<const int>();
+  REQUIRE(o);
+  REQUIRE(o->empty());
+  o.reset();
+  REQUIRE(!o);
+}
+
+TEST_CASE("string traits", "[container_traits][string]")
+{
+  using Opt = zxshady::tombstone_optional<std::string>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(std::string));
+
+  Opt o;
+  REQUIRE(!o);
+  o = "";
+  REQUIRE(o == "");
+  o = std::string("\0\0", 2);
+  REQUIRE(o.has_value());
+  o = "a string long enough to not fit in the small buffer";
+  REQUIRE(o->size() == 51);
+
+  Opt copy = o;
+  REQUIRE(copy == *o);
+  o.reset();
+  REQUIRE(!o);
+
+  Opt empty = o;
+  REQUIRE(!empty);
+  swap(empty, copy);
+  REQUIRE(!copy);
+  REQUIRE(empty->size() == 51);
+}
+
+TEST_CASE("vector traits", "[container_traits][vector]")
+{
+  using Opt = zxshady::tombstone_optional<std::vector<int>>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(std::vector<int>));
+
+  Opt o;
+  REQUIRE(!o);
+  o.emplace();
+  REQUIRE(o);
+  REQUIRE(o->empty());
+  o->push_back(42);
+  Opt moved = std::move(o);
+  REQUIRE((*moved)[0] == 42);
+  moved = std::nullopt;
+  REQUIRE(!moved);
+}
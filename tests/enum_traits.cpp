@@ -0,0 +1,78 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <zxshady/enum_traits.hpp>
+
+namespace protocol {
+enum class Opcode : std::uint8_t {
+  Ping,
+  Pong,
+  Data,
+};
+
+enum class Reserved : std::uint8_t {
+  First  = 0,
+  Last   = 0xff,
+  Almost = 0xfe,
+};
+
+enum Legacy : int {
+  LegacyA = -1,
+  LegacyB = 1,
+};
+
+enum class Custom : std::uint16_t {
+  A,
+  B,
+};
+} // namespace protocol
+
+namespace {
+// compilers print the enumerators of an enum in an anonymous namespace with a prefix such as `{anonymous}::`
+enum class Hidden : std::uint8_t {
+  Empty = 0,
+  Full  = 0xff,
+};
+} // namespace
+
+template<>
+inline constexpr protocol::Custom zxshady::tombstone_enum_null_value<protocol::Custom> = protocol::Custom{42};
+
+TEST_CASE("Enum traits", "[enum_traits]")
+{
+  using zxshady::tombstone_enum_null_value;
+
+  STATIC_REQUIRE(sizeof(zxshady::optional_enum<protocol::Opcode>) == 1);
+  STATIC_REQUIRE(sizeof(zxshady::optional_enum<protocol::Legacy>) == sizeof(int));
+
+  STATIC_REQUIRE(tombstone_enum_null_value<protocol::Opcode> == protocol::Opcode{0xff});
+  STATIC_REQUIRE(tombstone_enum_null_value<protocol::Reserved> == protocol::Reserved{0xfd});
+  STATIC_REQUIRE(static_cast<int>(tombstone_enum_null_value<protocol::Legacy>) == std::numeric_limits<int>::max());
+  STATIC_REQUIRE(tombstone_enum_null_value<protocol::Custom> == protocol::Custom{42});
+  STATIC_REQUIRE(tombstone_enum_null_value<Hidden> == Hidden{0xfe});
+
+  SECTION("Every enumerator is a value")
+  {
+    zxshady::optional_enum<protocol::Reserved> o;
+    REQUIRE(!o);
+    o = protocol::Reserved::Last;
+    REQUIRE(o == protocol::Reserved::Last);
+    o = protocol::Reserved::Almost;
+    REQUIRE(o.has_value());
+    o = protocol::Reserved::First;
+    REQUIRE(o.has_value());
+    o.reset();
+    REQUIRE(!o);
+
+    const zxshady::optional_enum<Hidden> hidden = Hidden::Full;
+    REQUIRE(hidden.has_value());
+    REQUIRE(*hidden == Hidden::Full);
+  }
+
+  SECTION("constexpr")
+  {
+    constexpr zxshady::optional_enum<protocol::Opcode> a;
+    constexpr zxshady::optional_enum<protocol::Opcode> b = protocol::Opcode::Pong;
+    STATIC_REQUIRE(!a);
+    STATIC_REQUIRE(*b == protocol::Opcode::Pong);
+  }
+}
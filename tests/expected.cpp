@@ -0,0 +1,83 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <zxshady/expected.hpp>
+
+namespace {
+enum class parse_errc : std::uint8_t {
+  invalid_digit,
+  overflow,
+  end_of_input,
+};
+
+using TopCodes = zxshady::tombstone_range_pattern<std::uint32_t{0xffff'ff00}, std::uint32_t{0xffff'ffff}>;
+using Result   = zxshady::tombstone_expected<std::uint32_t, parse_errc, TopCodes>;
+
+constexpr Result parse_digit(char c) noexcept
+{
+  if (c < '0' || c > '9')
+    return zxshady::tombstone_unexpected(parse_errc::invalid_digit);
+  return static_cast<std::uint32_t>(c - '0');
+}
+} // namespace
+
+TEST_CASE("tombstone_expected", "[expected]")
+{
+  STATIC_REQUIRE(sizeof(Result) == sizeof(std::uint32_t));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Result>);
+  STATIC_REQUIRE(Result::max_error == 255);
+
+  SECTION("constexpr")
+  {
+    constexpr Result ok  = parse_digit('7');
+    constexpr Result err = parse_digit('x');
+    STATIC_REQUIRE(ok.has_value());
+    STATIC_REQUIRE(*ok == 7);
+    STATIC_REQUIRE(!err);
+    STATIC_REQUIRE(err.error() == parse_errc::invalid_digit);
+    STATIC_REQUIRE(err == zxshady::tombstone_unexpected(parse_errc::invalid_digit));
+  }
+
+  SECTION("Every value below the reserved range is a value")
+  {
+    const Result r = std::uint32_t{0xffff'feff};
+    REQUIRE(r.has_value());
+    REQUIRE(r.value() == 0xffff'feff);
+  }
+
+  SECTION("value throws the error")
+  {
+    const Result r{zxshady::tombstone_unexpect, parse_errc::end_of_input};
+    bool         thrown = false;
+    try {
+      (void)r.value();
+    }
+    catch (const zxshady::bad_tombstone_expected_access<parse_errc>& e) {
+      thrown = e.error() == parse_errc::end_of_input;
+    }
+    REQUIRE(thrown);
+    REQUIRE(r.value_or(3u) == 3u);
+    REQUIRE(r.error_or(parse_errc::overflow) == parse_errc::end_of_input);
+  }
+
+  SECTION("Monadic operations")
+  {
+    const auto times_ten = [](std::uint32_t x) -> Result {
+      if (x > 0xffff'ffffu / 10)
+        return zxshady::tombstone_unexpected(parse_errc::overflow);
+      return x * 10;
+    };
+
+    REQUIRE(parse_digit('4').and_then(times_ten) == Result(40u));
+    REQUIRE(parse_digit('a').and_then(times_ten).error() == parse_errc::invalid_digit);
+    REQUIRE(Result(0x1fff'ffffu).and_then(times_ten).error() == parse_errc::overflow);
+
+    const auto doubled = parse_digit('4').transform<TopCodes>([](std::uint32_t x) { return x * 2; });
+    REQUIRE(*doubled == 8);
+
+    const auto code = parse_digit('?').transform_error([](parse_errc e) { return static_cast<int>(e) + 1; });
+    REQUIRE(code.error() == 1);
+
+    const auto recovered = parse_digit('?').or_else([](parse_errc) { return Result(0u); });
+    REQUIRE(*recovered == 0);
+  }
+}
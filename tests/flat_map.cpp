@@ -0,0 +1,266 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <zxshady/flat_map.hpp>
+
+namespace {
+constexpr std::uint64_t u64_max = std::numeric_limits<std::uint64_t>::max();
+
+// the two largest ids are the empty and erased slots
+using IdTraits = zxshady::tombstone_range_pattern<u64_max - 1, u64_max>;
+using IdMap    = zxshady::tombstone_flat_map<std::uint64_t, std::uint32_t, IdTraits>;
+
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+struct StringEqual {
+  using is_transparent = void;
+  bool operator()(std::string_view a, std::string_view b) const noexcept { return a == b; }
+};
+
+// a key that views a string, found by any string without converting it
+struct Label {
+  const char* text;
+
+  operator std::string_view() const noexcept { return text; }
+};
+
+// niche 0 is nullptr and niche 1 points at `erased`
+struct LabelTraits {
+  static constexpr char erased[] = "";
+
+  static constexpr std::size_t niche_count = 2;
+
+  static constexpr void initialize_null_state(Label& x) noexcept { x.text = nullptr; }
+  static constexpr bool is_null(const Label& x) noexcept { return x.text == nullptr; }
+
+  static constexpr std::size_t niche_index(const Label& x) noexcept
+  {
+    return x.text == nullptr ? 0 : x.text == erased ? 1 : 2;
+  }
+  static constexpr void initialize_niche(Label& x, std::size_t index) noexcept
+  {
+    x.text = index == 0 ? nullptr : erased;
+  }
+};
+
+// more aligned than `operator new` guarantees
+struct alignas(64) WideValue {
+  std::uint64_t value;
+};
+
+enum class Color : std::uint8_t {};
+
+using ColorTraits = zxshady::tombstone_range_pattern<Color{254}, Color{255}>;
+using StringMap   = zxshady::tombstone_flat_map<std::uint64_t, std::string, IdTraits>;
+} // namespace
+
+TEST_CASE("tombstone_flat_map", "[flat_map]")
+{
+  STATIC_REQUIRE(sizeof(*IdMap().begin()) == sizeof(std::pair<std::uint64_t, std::uint32_t>));
+
+  SECTION("Insert, find and erase")
+  {
+    IdMap map;
+    REQUIRE(map.empty());
+    REQUIRE(map.find(1) == map.end());
+    REQUIRE(map.begin() == map.end());
+
+    for (std::uint64_t i = 0; i < 1000; ++i)
+      REQUIRE(map.try_emplace(i * 7, static_cast<std::uint32_t>(i)).second);
+    REQUIRE(map.size() == 1000);
+    REQUIRE(!map.try_emplace(7, 99u).second);
+    REQUIRE(map.find(7)->second == 1);
+
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+      const auto it = map.find(i * 7);
+      REQUIRE(it != map.end());
+      REQUIRE(it->second == i);
+      REQUIRE(!map.contains(i * 7 + 1));
+    }
+
+    for (std::uint64_t i = 0; i < 1000; i += 2)
+      REQUIRE(map.erase(i * 7) == 1);
+    REQUIRE(map.erase(0) == 0);
+    REQUIRE(map.size() == 500);
+    for (std::uint64_t i = 0; i < 1000; ++i)
+      REQUIRE(map.contains(i * 7) == (i % 2 == 1));
+
+    std::size_t count = 0;
+    for (const auto& [key, value] : map) {
+      REQUIRE(key == value * 7u);
+      ++count;
+    }
+    REQUIRE(count == 500);
+
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE(map.begin() == map.end());
+  }
+
+  SECTION("Erased slots are reused")
+  {
+    IdMap map(64);
+    const std::size_t buckets = map.bucket_count();
+    for (int round = 0; round < 100; ++round) {
+      for (std::uint64_t i = 0; i < 40; ++i)
+        map[i] = static_cast<std::uint32_t>(i);
+      for (std::uint64_t i = 0; i < 40; ++i)
+        map.erase(i);
+    }
+    REQUIRE(map.empty());
+    REQUIRE(map.bucket_count() == buckets);
+  }
+
+  SECTION("Erase while iterating")
+  {
+    IdMap map;
+    for (std::uint64_t i = 0; i < 100; ++i)
+      map.insert({i, static_cast<std::uint32_t>(i)});
+    for (auto it = map.begin(); it != map.end();) {
+      if (it->second % 3 == 0)
+        it = map.erase(it);
+      else
+        ++it;
+    }
+    REQUIRE(map.size() == 66);
+  }
+
+  SECTION("Agrees with std::map")
+  {
+    IdMap                                   map;
+    std::map<std::uint64_t, std::uint32_t> reference;
+    std::mt19937_64                         rng(42);
+    for (int i = 0; i < 20000; ++i) {
+      const std::uint64_t key   = rng() % 512;
+      const auto          value = static_cast<std::uint32_t>(rng());
+      switch (rng() % 3) {
+      case 0:
+        map.insert_or_assign(key, value);
+        reference[key] = value;
+        break;
+      case 1: REQUIRE(map.erase(key) == reference.erase(key)); break;
+      default: {
+        const auto it = map.find(key);
+        const auto rt = reference.find(key);
+        REQUIRE((it == map.end()) == (rt == reference.end()));
+        if (rt != reference.end())
+          REQUIRE(it->second == rt->second);
+      }
+      }
+    }
+    REQUIRE(map.size() == reference.size());
+  }
+
+  SECTION("Batch lookup")
+  {
+    IdMap map;
+    for (std::uint64_t i = 0; i < 500; ++i)
+      map[i * 3] = static_cast<std::uint32_t>(i);
+
+    std::vector<std::uint64_t>    keys;
+    std::vector<IdMap::pointer> out(100);
+    for (std::uint64_t i = 0; i < 100; ++i)
+      keys.push_back(i * 5);
+    map.find_batch(std::span<const std::uint64_t>(keys), std::span(out));
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] % 3 == 0) {
+        REQUIRE(out[i] != nullptr);
+        REQUIRE(out[i]->first == keys[i]);
+        REQUIRE(out[i]->second == keys[i] / 3);
+      }
+      else {
+        REQUIRE(out[i] == nullptr);
+      }
+    }
+
+    IdMap empty;
+    empty.find_batch(std::span<const std::uint64_t>(keys), std::span(out));
+    for (const auto* p : out)
+      REQUIRE(p == nullptr);
+  }
+
+  SECTION("Non trivial values")
+  {
+    StringMap map;
+    for (std::uint64_t i = 0; i < 200; ++i)
+      map.try_emplace(i, 40, static_cast<char>('a' + i % 26));
+    StringMap copy = map;
+    for (std::uint64_t i = 0; i < 200; i += 2)
+      map.erase(i);
+    REQUIRE(map.size() == 100);
+    REQUIRE(copy.size() == 200);
+    REQUIRE(copy.find(4)->second == std::string(40, 'e'));
+
+    StringMap moved = std::move(map);
+    REQUIRE(moved.size() == 100);
+    REQUIRE(moved.find(3)->second == std::string(40, 'd'));
+  }
+
+  SECTION("Arguments that point into the map while growing")
+  {
+    StringMap map;
+    map.try_emplace(0, std::string(100, 'x'));
+    std::uint64_t key = 1;
+    while ((map.size() + 1) * StringMap::max_load_denominator <= map.bucket_count() * StringMap::max_load_numerator)
+      map.try_emplace(key++, "filler");
+    const std::size_t buckets = map.bucket_count();
+
+    // an existing key is found before anything moves
+    REQUIRE(!map.try_emplace(map.begin()->first, "ignored").second);
+    REQUIRE(map.bucket_count() == buckets);
+
+    const auto [it, inserted] = map.try_emplace(key, map.find(0)->second);
+    REQUIRE(inserted);
+    REQUIRE(map.bucket_count() > buckets);
+    REQUIRE(it->second == std::string(100, 'x'));
+    REQUIRE(map.find(0)->second == std::string(100, 'x'));
+  }
+
+  SECTION("Over aligned slots")
+  {
+    zxshady::tombstone_flat_map<std::uint64_t, WideValue, IdTraits> map;
+    for (std::uint64_t i = 0; i < 100; ++i)
+      map.try_emplace(i, WideValue{i});
+    REQUIRE(map.find(42)->second.value == 42);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&*map.begin()) % alignof(WideValue) == 0);
+  }
+
+  SECTION("Enum keys")
+  {
+    zxshady::tombstone_flat_map<Color, int, ColorTraits> map;
+    for (int i = 0; i < 254; ++i)
+      map[Color(i)] = i;
+    REQUIRE(map.size() == 254);
+    REQUIRE(map[Color(200)] == 200);
+  }
+
+  SECTION("Heterogeneous lookup")
+  {
+    zxshady::tombstone_flat_map<Label, int, LabelTraits, StringHash, StringEqual> map;
+    map.try_emplace(Label{"alpha"}, 1);
+    map.try_emplace(Label{"beta"}, 2);
+    map.try_emplace(Label{"gamma"}, 3);
+
+    using namespace std::string_view_literals;
+    REQUIRE(map.find("beta"sv)->second == 2);
+    REQUIRE(map.find(std::string("gamma"))->second == 3);
+    REQUIRE(!map.contains("delta"sv));
+    REQUIRE(map.erase(Label{"alpha"}) == 1);
+    REQUIRE(!map.contains("alpha"sv));
+
+    const std::vector<std::string_view> keys{"gamma", "alpha", "beta"};
+    std::vector<decltype(map)::pointer> out(keys.size());
+    map.find_batch(std::span(keys), std::span(out));
+    REQUIRE(out[0]->second == 3);
+    REQUIRE(out[1] == nullptr);
+    REQUIRE(out[2]->second == 2);
+  }
+}
@@ -0,0 +1,120 @@
+#include "interface.hpp"
+#include <functional>
+#include <memory>
+#include <zxshady/handle_traits.hpp>
+
+namespace {
+struct CountingDeleter {
+  int* count;
+  CountingDeleter() noexcept : count(nullptr) {}
+  explicit CountingDeleter(int& c) noexcept : count(&c) {}
+  void operator()(int* p) const noexcept
+  {
+    ++*count;
+    delete p;
+  }
+};
+
+// counts the live deleters, the null state holds one too
+struct OwningDeleter {
+  static inline int live = 0;
+
+  std::unique_ptr<int> state = std::make_unique<int>(0);
+
+  OwningDeleter() noexcept { ++live; }
+  OwningDeleter(OwningDeleter&& that) noexcept : state(std::move(that.state)) { ++live; }
+  OwningDeleter& operator=(OwningDeleter&&) noexcept = default;
+  ~OwningDeleter() { --live; }
+
+  void operator()(int* p) const noexcept { delete p; }
+};
+} // namespace
+
+TEST_CASE("File descriptor traits", "[handle_traits][fd]")
+{
+  STATIC_REQUIRE(sizeof(zxshady::optional_fd) == sizeof(int));
+
+  constexpr zxshady::optional_fd closed;
+  constexpr zxshady::optional_fd stdin_fd = 0;
+  STATIC_REQUIRE(!closed);
+  STATIC_REQUIRE(*stdin_fd == 0);
+}
+
+TEST_CASE("unique_ptr traits", "[handle_traits][unique_ptr]")
+{
+  using Ptr = std::unique_ptr<int, CountingDeleter>;
+  using Opt = zxshady::tombstone_optional<Ptr>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(Ptr));
+  STATIC_REQUIRE(sizeof(zxshady::tombstone_optional<std::unique_ptr<int>>) == sizeof(int*));
+
+  int destroyed = 0;
+  {
+    Opt o;
+    REQUIRE(!o);
+    o = Ptr(new int(42), CountingDeleter(destroyed));
+    REQUIRE(**o == 42);
+
+    Opt moved = std::move(o);
+    REQUIRE(**moved == 42);
+    REQUIRE(destroyed == 0);
+
+    moved.reset();
+    REQUIRE(destroyed == 1);
+    moved.emplace(new int(7), CountingDeleter(destroyed));
+  }
+  REQUIRE(destroyed == 2);
+
+  SECTION("A deleter with a destructor")
+  {
+    using OwningPtr = std::unique_ptr<int, OwningDeleter>;
+    using OwningOpt = zxshady::tombstone_optional<OwningPtr>;
+    STATIC_REQUIRE(
+      !zxshady::concepts::tombstone_trivial_destroy_traits_for<zxshady::tombstone_traits<OwningPtr>, OwningPtr>);
+    {
+      OwningOpt o;
+      REQUIRE(OwningDeleter::live == 1);
+      o.emplace(new int(1));
+      REQUIRE(**o == 1);
+      o.reset();
+      OwningOpt other;
+      other = std::move(o);
+      REQUIRE(!other);
+    }
+    REQUIRE(OwningDeleter::live == 0);
+  }
+}
+
+TEST_CASE("shared_ptr traits", "[handle_traits][shared_ptr]")
+{
+  using Opt = zxshady::tombstone_optional<std::shared_ptr<int>>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(std::shared_ptr<int>));
+
+  auto shared = std::make_shared<int>(42);
+  Opt  o;
+  REQUIRE(!o);
+  o = shared;
+  REQUIRE(shared.use_count() == 2);
+  o.reset();
+  REQUIRE(shared.use_count() == 1);
+
+  SECTION("Owning nullptr is a value")
+  {
+    Opt owning = std::shared_ptr<int>(shared, nullptr);
+    REQUIRE(owning);
+    REQUIRE(shared.use_count() == 2);
+  }
+  REQUIRE(shared.use_count() == 1);
+}
+
+TEST_CASE("std::function traits", "[handle_traits][function]")
+{
+  using Opt = zxshady::tombstone_optional<std::function<int(int)>>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(std::function<int(int)>));
+
+  Opt o;
+  REQUIRE(!o);
+  o = [](int x) { return x * 2; };
+  REQUIRE((*o)(21) == 42);
+  o = std::nullopt;
+  REQUIRE(!o);
+}
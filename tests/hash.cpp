@@ -1,6 +1,7 @@
 #include "interface.hpp"
 #include <functional>
 #include <unordered_set>
+#include <zxshady/hash.hpp>
 
 TEST_CASE("Hashing", "[hash]")
 {
@@ -45,3 +46,52 @@ TEST_CASE("Hashing", "[hash]")
     REQUIRE(optSet.size() == 2);
   }
 }
+
+TEST_CASE("Transparent hashing", "[hash][transparent]")
+{
+  using Hash  = zxshady::tombstone_hash<std::string, StringSetToNullInterface<std::string>>;
+  using Equal = zxshady::tombstone_equal<std::string, StringSetToNullInterface<std::string>>;
+
+  STATIC_REQUIRE(zxshady::tombstone_hash_compatible_v<std::string, std::string_view>);
+  STATIC_REQUIRE(zxshady::tombstone_hash_compatible_v<std::string, const char*>);
+  STATIC_REQUIRE(zxshady::tombstone_hash_compatible_v<std::string, char[4]>);
+  STATIC_REQUIRE(!zxshady::tombstone_hash_compatible_v<std::string, int>);
+  STATIC_REQUIRE(!zxshady::tombstone_hash_compatible_v<std::string_view, std::string>);
+
+  SECTION("Consistent with std::hash")
+  {
+    const Hash                 hash;
+    const std::hash<OptString> std_hash;
+    const OptString            key = "Hello";
+    REQUIRE(hash(key) == std_hash(key));
+    REQUIRE(hash(std::string_view("Hello")) == std_hash(key));
+    REQUIRE(hash("Hello") == std_hash(key));
+    REQUIRE(hash(OptStringView("Hello")) == std_hash(key));
+    REQUIRE(hash(std::nullopt) == std_hash(OptString()));
+    REQUIRE(hash(OptStringView()) == std_hash(OptString()));
+  }
+
+  SECTION("Equality")
+  {
+    const Equal equal;
+    REQUIRE(equal(OptString("a"), std::string_view("a")));
+    REQUIRE(equal("a", OptString("a")));
+    REQUIRE(!equal(OptString("a"), std::string_view("b")));
+    REQUIRE(equal(OptString(), std::nullopt));
+    REQUIRE(equal(OptString(), OptString()));
+    REQUIRE(!equal(OptString("a"), std::nullopt));
+    REQUIRE(equal(OptStringView("a"), OptString("a")));
+  }
+
+  SECTION("Lookup without a temporary")
+  {
+    std::unordered_set<OptString, Hash, Equal> set;
+    set.insert(OptString("Test1"));
+    set.insert(OptString());
+
+    REQUIRE(set.find(std::string_view("Test1")) != set.end());
+    REQUIRE(set.find("Test2") == set.end());
+    REQUIRE(set.find(std::nullopt) != set.end());
+    REQUIRE(set.count(OptStringView("Test1")) == 1);
+  }
+}
@@ -0,0 +1,78 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <zxshady/hash.hpp>
+
+namespace {
+struct CustomNullHashTraits : zxshady::tombstone_value_pattern<-1> {
+  static constexpr std::size_t null_hash = 12345;
+};
+
+template<typename Optional>
+void CheckBatch(const std::vector<Optional>& v)
+{
+  using T      = typename Optional::value_type;
+  using Traits = typename Optional::traits_type;
+
+  std::vector<std::size_t> hashes(v.size());
+  zxshady::hash_batch(std::span(v), std::span(hashes));
+  const zxshady::tombstone_mix_hash<T, Traits> hash;
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    REQUIRE(hashes[i] == hash(v[i]));
+    if (!v[i])
+      REQUIRE(hashes[i] == zxshady::tombstone_null_hash_v<Traits>);
+  }
+}
+} // namespace
+
+TEST_CASE("Null hash", "[hash][null]")
+{
+  using OptInt = zxshady::tombstone_optional<int, zxshady::tombstone_min_traits<int>>;
+  STATIC_REQUIRE(zxshady::tombstone_null_hash_v<zxshady::tombstone_min_traits<int>> ==
+                 ZXSHADY_OPTIONAL_TOMBSTONE_NULL_HASH);
+  STATIC_REQUIRE(zxshady::tombstone_null_hash_v<CustomNullHashTraits> == 12345);
+
+  REQUIRE(std::hash<OptInt>{}(OptInt()) == ZXSHADY_OPTIONAL_TOMBSTONE_NULL_HASH);
+  REQUIRE(std::hash<OptInt>{}(OptInt()) != std::hash<OptInt>{}(OptInt(0)));
+  REQUIRE(std::hash<zxshady::tombstone_optional<int, CustomNullHashTraits>>{}(std::nullopt) == 12345);
+}
+
+TEST_CASE("hash_batch", "[hash][batch]")
+{
+  SECTION("Constant null pattern")
+  {
+    std::vector<zxshady::tombstone_optional<std::int32_t, zxshady::tombstone_min_traits<std::int32_t>>> a(1000);
+    for (std::size_t i = 0; i < a.size(); i += 3)
+      a[i] = static_cast<std::int32_t>(i);
+    CheckBatch(a);
+
+    std::vector<zxshady::tombstone_optional<int, CustomNullHashTraits>> b(100);
+    b[5] = 0;
+    CheckBatch(b);
+
+    std::vector<zxshady::tombstone_optional<std::uint8_t, zxshady::tombstone_max_traits<std::uint8_t>>> c(70);
+    c[69] = std::uint8_t{1};
+    CheckBatch(c);
+
+    int                                            objects[10];
+    std::vector<zxshady::tombstone_optional<int*>> d(10);
+    d[3] = &objects[3];
+    CheckBatch(d);
+  }
+
+  SECTION("Other traits")
+  {
+    std::vector<zxshady::tombstone_optional<std::uint64_t, DefaultConstructorInterface>> v(10);
+    v[1] = 7u;
+    CheckBatch(v);
+  }
+
+  SECTION("Values are spread")
+  {
+    const zxshady::tombstone_mix_hash<std::uint32_t, zxshady::tombstone_max_traits<std::uint32_t>> hash;
+    REQUIRE(hash(0u) != 0);
+    REQUIRE(hash(1u) != hash(2u));
+    REQUIRE((hash(1u) >> 32) != 0);
+  }
+}
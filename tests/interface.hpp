@@ -28,6 +28,7 @@ struct Interface;
 template<typename T>
 struct ZeroBitPatternInterface {
   static_assert(std::is_trivially_copyable_v<T>, "");
+  static constexpr bool null_is_zero_bits = true;
   static bool is_null(const T& x) noexcept
   {
     static const auto zero = []() {
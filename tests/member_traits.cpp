@@ -0,0 +1,89 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <string>
+
+namespace {
+struct Record {
+  std::uint64_t id;
+  double        score;
+  std::uint32_t flags;
+};
+
+struct Node {
+  Node* next;
+  int   value;
+};
+
+struct Named {
+  const char* key;
+  std::string name;
+};
+
+using RecordTraits = zxshady::tombstone_member_traits<&Record::id, zxshady::tombstone_max_traits<std::uint64_t>>;
+} // namespace
+
+TEST_CASE("Member traits", "[member_traits]")
+{
+  using Opt = zxshady::tombstone_optional<Record, RecordTraits>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(Record));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Opt>);
+  STATIC_REQUIRE(std::is_trivially_destructible_v<Opt>);
+
+  Opt o;
+  REQUIRE(!o);
+  o = Record{1, 2.5, 3};
+  REQUIRE(o->id == 1);
+  REQUIRE(o->score == 2.5);
+  o.reset();
+  REQUIRE(!o);
+
+  Record r{};
+  RecordTraits::initialize_null_state(r);
+  REQUIRE(r.id == UINT64_MAX);
+  REQUIRE(r.score == 0.0);
+  REQUIRE(r.flags == 0);
+}
+
+TEST_CASE("Member traits with default member traits", "[member_traits]")
+{
+  using Opt = zxshady::tombstone_optional<Node, zxshady::tombstone_member_traits<&Node::next>>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(Node));
+
+  Node tail{nullptr, 2};
+  Opt  o;
+  REQUIRE(!o);
+  o = Node{&tail, 1};
+  REQUIRE(o->next->value == 2);
+}
+
+TEST_CASE("Member traits forward niches", "[member_traits][niche]")
+{
+  using Ids    = zxshady::tombstone_range_pattern<std::uint64_t{UINT64_MAX - 1}, std::uint64_t{UINT64_MAX}>;
+  using Traits = zxshady::tombstone_member_traits<&Record::id, Ids>;
+  STATIC_REQUIRE(zxshady::tombstone_niche_count_v<Traits, Record> == 2);
+
+  using Opt2 = zxshady::tombstone_optional<zxshady::tombstone_optional<Record, Traits>>;
+  STATIC_REQUIRE(sizeof(Opt2) == sizeof(Record));
+
+  Opt2 o;
+  REQUIRE(!o);
+  o.emplace();
+  REQUIRE(o);
+  REQUIRE(!*o);
+  o->emplace(Record{4, 0.0, 0});
+  REQUIRE((*o)->id == 4);
+}
+
+TEST_CASE("Member traits on a non trivial class", "[member_traits]")
+{
+  using Opt = zxshady::tombstone_optional<Named, zxshady::tombstone_member_traits<&Named::key>>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(Named));
+
+  Opt o;
+  REQUIRE(!o);
+  o = Named{"k", "a string long enough to not fit in the small buffer"};
+  Opt copy = o;
+  REQUIRE(copy->name == o->name);
+  o.reset();
+  REQUIRE(!o);
+}
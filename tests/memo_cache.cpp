@@ -0,0 +1,89 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <string>
+#include <zxshady/memo_cache.hpp>
+
+namespace {
+using IdTraits = zxshady::tombstone_max_traits<std::uint32_t>;
+
+template<std::size_t Ways>
+using Cache = zxshady::tombstone_memo_cache<std::uint32_t, double, 64, IdTraits, Ways>;
+} // namespace
+
+TEST_CASE("tombstone_memo_cache", "[memo_cache]")
+{
+  STATIC_REQUIRE(sizeof(Cache<1>) == 64 * sizeof(std::pair<std::uint32_t, double>) + 2 * sizeof(std::size_t));
+
+  SECTION("Hits and misses")
+  {
+    Cache<1> cache;
+    int      calls   = 0;
+    auto     compute = [&](std::uint32_t id) {
+      ++calls;
+      return id * 1.5;
+    };
+    REQUIRE(cache.find(3) == nullptr);
+    REQUIRE(cache.get_or_compute(3, compute) == 4.5);
+    REQUIRE(cache.get_or_compute(3, compute) == 4.5);
+    REQUIRE(calls == 1);
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 1);
+    REQUIRE(*cache.find(3) == 4.5);
+
+    REQUIRE(cache.invalidate(3));
+    REQUIRE(!cache.invalidate(3));
+    REQUIRE(cache.get_or_compute(3, compute) == 4.5);
+    REQUIRE(calls == 2);
+
+    cache.reset_counters();
+    REQUIRE(cache.hits() == 0);
+    REQUIRE(cache.misses() == 0);
+    cache.clear();
+    REQUIRE(cache.find(3) == nullptr);
+  }
+
+  SECTION("Results are always correct")
+  {
+    Cache<1> direct;
+    Cache<2> two_way;
+    for (std::uint32_t i = 0; i < 10000; ++i) {
+      const std::uint32_t id = (i * 7919u) % 300u;
+      REQUIRE(direct.get_or_compute(id, [](std::uint32_t x) { return x * 2.0; }) == id * 2.0);
+      REQUIRE(two_way.get_or_compute(id, [](std::uint32_t x) { return x * 2.0; }) == id * 2.0);
+    }
+    REQUIRE(direct.hits() + direct.misses() == 10000);
+    REQUIRE(two_way.hits() + two_way.misses() == 10000);
+  }
+
+  SECTION("Two ways evict the least recently used entry")
+  {
+    // a single set so every key collides
+    zxshady::tombstone_memo_cache<std::uint32_t, double, 2, IdTraits, 2> cache;
+    const auto compute = [](std::uint32_t x) { return x * 1.0; };
+    cache.get_or_compute(1, compute);
+    cache.get_or_compute(2, compute);
+    REQUIRE(cache.find(1));
+    REQUIRE(cache.find(2));
+
+    cache.get_or_compute(1, compute);
+    cache.get_or_compute(3, compute);
+    REQUIRE(cache.find(1));
+    REQUIRE(!cache.find(2));
+    REQUIRE(cache.find(3));
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 3);
+
+    REQUIRE(cache.invalidate(3));
+    cache.get_or_compute(4, compute);
+    REQUIRE(cache.find(1));
+    REQUIRE(cache.find(4));
+  }
+
+  SECTION("Non trivial values")
+  {
+    zxshady::tombstone_memo_cache<std::uint32_t, std::string, 8, IdTraits, 2> cache;
+    for (std::uint32_t i = 0; i < 100; ++i)
+      REQUIRE(cache.get_or_compute(i % 20, [](std::uint32_t x) { return std::string(30, static_cast<char>('a' + x)); }) ==
+              std::string(30, static_cast<char>('a' + i % 20)));
+  }
+}
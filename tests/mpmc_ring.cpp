@@ -0,0 +1,176 @@
+#include "interface.hpp"
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <zxshady/mpmc_ring.hpp>
+
+namespace {
+using Traits = zxshady::tombstone_max_traits<std::uint64_t>;
+
+template<bool Padded>
+using Ring = zxshady::tombstone_mpmc_ring<std::uint64_t, Traits, Padded>;
+
+// stalls a producer between claiming its ticket and writing its slot, the slot compares against the null state
+// that `initialize_null_state` makes
+struct StallingTraits : Traits {
+  static inline thread_local bool stall = false;
+  static inline std::atomic<bool> resume{false};
+
+  static void initialize_null_state(std::uint64_t& x) noexcept
+  {
+    if (std::exchange(stall, false))
+      while (!resume.load())
+        std::this_thread::yield();
+    Traits::initialize_null_state(x);
+  }
+};
+
+// every value pushed by `producers` threads is popped exactly once by `consumers` threads
+template<bool Padded>
+bool Stress(int producers, int consumers, std::uint64_t per_producer, std::size_t batch)
+{
+  Ring<Padded>                  ring(64);
+  const std::uint64_t           total = per_producer * static_cast<std::uint64_t>(producers);
+  std::vector<std::atomic<int>> seen(total);
+  std::atomic<std::uint64_t>    popped{0};
+  std::vector<std::thread>      threads;
+
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      std::vector<std::uint64_t> values;
+      for (std::uint64_t i = 0; i < per_producer; ++i)
+        values.push_back(static_cast<std::uint64_t>(p) * per_producer + i);
+      std::span<const std::uint64_t> rest(values);
+      while (!rest.empty()) {
+        const std::size_t pushed = ring.try_push_n(rest.first(std::min(batch, rest.size())));
+        rest                     = rest.subspan(pushed);
+        if (pushed == 0)
+          std::this_thread::yield();
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      std::vector<std::uint64_t> out(batch);
+      while (popped.load(std::memory_order_relaxed) < total) {
+        const std::size_t count = ring.try_pop_n(out);
+        for (std::size_t i = 0; i < count; ++i)
+          seen[out[i]].fetch_add(1, std::memory_order_relaxed);
+        popped.fetch_add(count, std::memory_order_relaxed);
+        if (count == 0)
+          std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (const auto& count : seen)
+    if (count.load() != 1)
+      return false;
+  return ring.size_approx() == 0;
+}
+} // namespace
+
+TEST_CASE("tombstone_mpmc_ring", "[mpmc_ring]")
+{
+  STATIC_REQUIRE(alignof(Ring<true>) == 64);
+
+  SECTION("Single thread")
+  {
+    Ring<false> ring(5);
+    REQUIRE(ring.capacity() == 8);
+    REQUIRE(!ring.try_pop());
+
+    for (std::uint64_t round = 0; round < 3; ++round) {
+      for (std::uint64_t i = 0; i < 8; ++i)
+        REQUIRE(ring.try_push(round * 100 + i));
+      REQUIRE(!ring.try_push(0));
+      REQUIRE(ring.size_approx() == 8);
+      for (std::uint64_t i = 0; i < 8; ++i)
+        REQUIRE(*ring.try_pop() == round * 100 + i);
+      REQUIRE(!ring.try_pop());
+    }
+  }
+
+  SECTION("The null state is never pushed")
+  {
+    constexpr std::uint64_t null = std::numeric_limits<std::uint64_t>::max();
+
+    Ring<false> ring(4);
+    REQUIRE(!ring.try_push(null));
+    REQUIRE(ring.size_approx() == 0);
+    const std::vector<std::uint64_t> values{1, null, 2};
+    REQUIRE(ring.try_push_n(values) == 1);
+    REQUIRE(ring.size_approx() == 1);
+    REQUIRE(*ring.try_pop() == 1);
+    REQUIRE(!ring.try_pop());
+  }
+
+  SECTION("Batches")
+  {
+    Ring<true>                       ring(8);
+    const std::vector<std::uint64_t> values{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    REQUIRE(ring.try_push_n(values) == 8);
+    REQUIRE(ring.try_push_n(values) == 0);
+
+    std::vector<std::uint64_t> out(3);
+    REQUIRE(ring.try_pop_n(out) == 3);
+    REQUIRE(out == std::vector<std::uint64_t>{1, 2, 3});
+    REQUIRE(ring.try_push_n(values) == 3);
+
+    out.resize(20);
+    REQUIRE(ring.try_pop_n(out) == 8);
+    REQUIRE(out[0] == 4);
+    REQUIRE(out[7] == 3);
+  }
+
+  SECTION("Stress")
+  {
+    REQUIRE(Stress<true>(1, 1, 20000, 1));
+    REQUIRE(Stress<false>(2, 2, 5000, 4));
+    REQUIRE(Stress<true>(4, 2, 2000, 8));
+    REQUIRE(Stress<false>(3, 5, 2000, 1));
+    REQUIRE(Stress<true>(8, 8, 500, 16));
+    REQUIRE(Stress<false>(32, 32, 100, 2));
+  }
+
+  SECTION("A slot is not FIFO across laps")
+  {
+    zxshady::tombstone_mpmc_ring<std::uint64_t, StallingTraits, false> ring(2);
+
+    // claims ticket 0 and stops before writing slot 0
+    bool        pushed = false;
+    std::thread stalled([&] {
+      StallingTraits::stall = true;
+      pushed                = ring.try_push(100);
+    });
+    while (ring.size_approx() != 1)
+      std::this_thread::yield();
+    REQUIRE(ring.try_push(1)); // ticket 1, slot 1
+
+    std::uint64_t first  = 0;
+    std::uint64_t second = 0;
+    std::thread   consumer([&] {
+      first  = *ring.try_pop(); // ticket 0, waits for slot 0
+      second = *ring.try_pop(); // ticket 1
+    });
+    while (ring.size_approx() != 1)
+      std::this_thread::yield();
+    REQUIRE(ring.try_push(2)); // ticket 2, slot 0 is still empty
+    consumer.join();
+    REQUIRE(first == 2);
+    REQUIRE(second == 1);
+
+    StallingTraits::resume = true;
+    stalled.join();
+    REQUIRE(pushed);
+    REQUIRE(*ring.try_pop() == 100);
+    REQUIRE(!ring.try_pop());
+  }
+}
@@ -0,0 +1,78 @@
+#include "interface.hpp"
+#include <cstdint>
+
+using Int32Niches = zxshady::tombstone_range_pattern<INT32_MIN, INT32_MIN + 2>;
+using Opt1        = zxshady::tombstone_optional<std::int32_t, Int32Niches>;
+using Opt2        = zxshady::tombstone_optional<Opt1>;
+using Opt3        = zxshady::tombstone_optional<Opt2>;
+
+TEST_CASE("Niche counts", "[niche]")
+{
+  STATIC_REQUIRE(zxshady::tombstone_niche_count_v<Int32Niches, std::int32_t> == 3);
+  STATIC_REQUIRE(zxshady::tombstone_niche_count_v<zxshady::tombstone_traits<Opt1>, Opt1> == 2);
+  STATIC_REQUIRE(zxshady::tombstone_niche_count_v<zxshady::tombstone_traits<Opt2>, Opt2> == 1);
+  STATIC_REQUIRE(zxshady::tombstone_niche_count_v<zxshady::tombstone_traits<int*>, int*> == 1);
+  STATIC_REQUIRE(zxshady::tombstone_niche_count_v<zxshady::tombstone_traits<bool>, bool> == 254);
+
+  STATIC_REQUIRE(sizeof(Opt2) == sizeof(std::int32_t));
+  STATIC_REQUIRE(sizeof(Opt3) == sizeof(std::int32_t));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Opt3>);
+}
+
+TEST_CASE("Nested optionals", "[niche]")
+{
+  SECTION("constexpr")
+  {
+    constexpr Opt2 outer_null;
+    constexpr Opt2 inner_null = Opt1{};
+    constexpr Opt2 value      = 42;
+
+    STATIC_REQUIRE(!outer_null);
+    STATIC_REQUIRE(inner_null);
+    STATIC_REQUIRE(!*inner_null);
+    STATIC_REQUIRE(value);
+    STATIC_REQUIRE(**value == 42);
+  }
+
+  SECTION("Three levels")
+  {
+    Opt3 o;
+    REQUIRE(!o);
+    o = Opt2{};
+    REQUIRE(o);
+    REQUIRE(!*o);
+    o = Opt2{Opt1{}};
+    REQUIRE(*o);
+    REQUIRE(!**o);
+    o = Opt2{Opt1{7}};
+    REQUIRE(***o == 7);
+    o.reset();
+    REQUIRE(!o);
+  }
+
+  SECTION("bool")
+  {
+    using BoolOpt2 = zxshady::tombstone_optional<zxshady::tombstone_optional<bool>>;
+    STATIC_REQUIRE(sizeof(BoolOpt2) == 1);
+
+    BoolOpt2 o;
+    REQUIRE(!o);
+    o = zxshady::tombstone_optional<bool>{};
+    REQUIRE(o);
+    REQUIRE(!*o);
+    o = zxshady::tombstone_optional<bool>{false};
+    REQUIRE(**o == false);
+  }
+}
+
+TEST_CASE("Range pattern", "[niche][range_pattern]")
+{
+  using Range = zxshady::tombstone_range_pattern<std::uint8_t{250}, std::uint8_t{255}>;
+  STATIC_REQUIRE(Range::niche_count == 6);
+  STATIC_REQUIRE(Range::niche_index(250) == 0);
+  STATIC_REQUIRE(Range::niche_index(255) == 5);
+  STATIC_REQUIRE(Range::niche_index(0) == 6);
+  STATIC_REQUIRE(Range::niche_index(249) == 6);
+  STATIC_REQUIRE(Range::is_null(250));
+  STATIC_REQUIRE(!Range::is_null(251));
+}
@@ -0,0 +1,101 @@
+#include "interface.hpp"
+#include <memory>
+#include <zxshady/enum_traits.hpp>
+#include <zxshady/handle_traits.hpp>
+#include <zxshady/null_fill.hpp>
+
+namespace {
+struct alignas(64) Wide {
+  int value;
+};
+
+struct WideTraits {
+  static bool is_null(const Wide& x) noexcept { return x.value == -1; }
+  static void initialize_null_state(Wide& x) noexcept { x.value = -1; }
+};
+
+enum class Color : std::uint8_t { Red, Green };
+} // namespace
+
+TEST_CASE("tombstone_null_byte_v", "[null_fill][traits]")
+{
+  using zxshady::tombstone_null_byte_v;
+  using zxshady::tombstone_traits;
+
+  STATIC_REQUIRE(tombstone_null_byte_v<tombstone_traits<int*>, int*> == 0);
+  STATIC_REQUIRE(tombstone_null_byte_v<tombstone_traits<std::unique_ptr<int>>, std::unique_ptr<int>> == 0);
+  STATIC_REQUIRE(tombstone_null_byte_v<ZeroBitPatternInterface<double>, double> == 0);
+  STATIC_REQUIRE(tombstone_null_byte_v<tombstone_traits<bool>, bool> == 0xff);
+  STATIC_REQUIRE(tombstone_null_byte_v<zxshady::tombstone_max_traits<std::byte>, std::byte> == 0xff);
+  STATIC_REQUIRE(tombstone_null_byte_v<zxshady::tombstone_value_pattern<-1>, int> == 0xff);
+  STATIC_REQUIRE(tombstone_null_byte_v<zxshady::tombstone_enum_traits<Color>, Color> == 0xff);
+
+  STATIC_REQUIRE(!tombstone_null_byte_v<zxshady::tombstone_value_pattern<0x0102>, int>);
+  STATIC_REQUIRE(!tombstone_null_byte_v<tombstone_traits<float>, float>);
+  STATIC_REQUIRE(!tombstone_null_byte_v<WideTraits, Wide>);
+}
+
+TEST_CASE("uninitialized_fill_null", "[null_fill]")
+{
+  SECTION("Byte pattern")
+  {
+    alignas(bool) unsigned char storage[16];
+    auto* const first = reinterpret_cast<zxshady::tombstone_optional<bool>*>(storage);
+    zxshady::uninitialized_fill_null(first, first + 16);
+    for (int i = 0; i < 16; ++i)
+      REQUIRE(!first[i]);
+  }
+
+  SECTION("Initialize each element")
+  {
+    alignas(float) unsigned char storage[16 * sizeof(float)];
+    auto* const first = reinterpret_cast<zxshady::tombstone_optional<float>*>(storage);
+    zxshady::uninitialized_fill_null(first, first + 16);
+    for (int i = 0; i < 16; ++i)
+      REQUIRE(!first[i]);
+  }
+}
+
+TEST_CASE("make_null_array", "[null_fill]")
+{
+  SECTION("Zero bits")
+  {
+    auto small = zxshady::make_null_array<int*>(100);
+    for (std::size_t i = 0; i < 100; ++i)
+      REQUIRE(!small[i]);
+
+    // large enough to map fresh pages
+    constexpr std::size_t count = std::size_t{1} << 18;
+    auto large = zxshady::make_null_array<std::unique_ptr<int>>(count);
+    REQUIRE(large.get_deleter().size() == count);
+    REQUIRE(!large[0]);
+    REQUIRE(!large[count - 1]);
+    large[count / 2] = std::make_unique<int>(5);
+    REQUIRE(**large[count / 2] == 5);
+  }
+
+  SECTION("Repeated byte")
+  {
+    auto a = zxshady::make_null_array<bool>(1000);
+    REQUIRE(!a[0]);
+    REQUIRE(!a[999]);
+    a[3] = false;
+    REQUIRE(a[3] == false);
+  }
+
+  SECTION("Other patterns")
+  {
+    auto doubles = zxshady::make_null_array<double>(10);
+    REQUIRE(!doubles[9]);
+
+    auto wide = zxshady::make_null_array<Wide, WideTraits>(10);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(wide.get()) % 64 == 0);
+    REQUIRE(!wide[9]);
+  }
+
+  SECTION("Empty")
+  {
+    auto empty = zxshady::make_null_array<int*>(0);
+    REQUIRE(empty.get() != nullptr);
+  }
+}
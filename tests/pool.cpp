@@ -0,0 +1,131 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <zxshady/pool.hpp>
+
+namespace {
+// the top 16 bits of an id are never set, they give 65535 niches
+using IdTraits = zxshady::tombstone_spare_bits<std::uint64_t, 0xffff'0000'0000'0000>;
+using IdPool   = zxshady::tombstone_pool<std::uint64_t, IdTraits>;
+
+struct Session {
+  std::uint64_t id;
+  std::string   name;
+
+  Session(std::uint64_t i, std::string n) : id(i), name(std::move(n))
+  {
+    if (name == "throw")
+      throw std::runtime_error("bad session");
+  }
+};
+
+using SessionTraits = zxshady::tombstone_member_traits<&Session::id, IdTraits>;
+using SessionPool   = zxshady::tombstone_pool<Session, SessionTraits>;
+} // namespace
+
+TEST_CASE("tombstone_pool", "[pool]")
+{
+  STATIC_REQUIRE(IdPool::max_capacity == 65533);
+
+  SECTION("Create and destroy")
+  {
+    IdPool pool(8);
+    REQUIRE(pool.empty());
+    std::vector<std::uint64_t*> objects;
+    for (std::uint64_t i = 0; i < 8; ++i) {
+      objects.push_back(pool.create(i * 10));
+      REQUIRE(objects.back() != nullptr);
+      REQUIRE(pool.index_of(objects.back()) == i);
+    }
+    REQUIRE(pool.full());
+    REQUIRE(pool.create(1u) == nullptr);
+
+    // freed slots are reused last in, first out
+    pool.destroy(objects[2]);
+    pool.destroy(objects[5]);
+    REQUIRE(pool.size() == 6);
+    REQUIRE(pool.index_of(pool.create(1u)) == 5);
+    REQUIRE(pool.index_of(pool.create(2u)) == 2);
+    REQUIRE(pool.create(3u) == nullptr);
+
+    std::uint64_t sum = 0;
+    pool.for_each_live([&](std::uint64_t x) { sum += x; });
+    REQUIRE(sum == 10 + 30 + 40 + 60 + 70 + 1 + 2);
+
+    pool.clear();
+    REQUIRE(pool.empty());
+    for (std::size_t i = 0; i < 8; ++i)
+      REQUIRE(pool.index_of(pool.create(std::uint64_t{0})) == i);
+  }
+
+  SECTION("Random churn")
+  {
+    IdPool                    pool(1000);
+    std::set<std::uint64_t*>  live;
+    std::uint64_t             state = 1;
+    for (int step = 0; step < 20000; ++step) {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      if ((state >> 33) % 3 != 0 || live.empty()) {
+        if (std::uint64_t* p = pool.create(state >> 16)) {
+          REQUIRE(live.insert(p).second);
+        }
+        else {
+          REQUIRE(pool.full());
+        }
+      }
+      else {
+        auto it = live.begin();
+        std::advance(it, static_cast<std::ptrdiff_t>((state >> 40) % live.size()));
+        pool.destroy(*it);
+        live.erase(it);
+      }
+      REQUIRE(pool.size() == live.size());
+    }
+    std::size_t count = 0;
+    pool.for_each_live([&](std::uint64_t&) { ++count; });
+    REQUIRE(count == live.size());
+  }
+
+  SECTION("Objects that are niches are rejected")
+  {
+    IdPool pool(4);
+    REQUIRE(pool.create(std::uint64_t{1}));
+    // niche 2 of the spare bits, it would read back as a link to slot 1
+    REQUIRE_THROWS_AS(pool.create(std::uint64_t{0x0003'0000'0000'0000}), std::invalid_argument);
+    REQUIRE(pool.size() == 1);
+    std::size_t count = 0;
+    pool.for_each_live([&](std::uint64_t) { ++count; });
+    REQUIRE(count == 1);
+    REQUIRE(pool.index_of(pool.create(std::uint64_t{2})) == 1);
+    REQUIRE(pool.index_of(pool.create(std::uint64_t{3})) == 2);
+  }
+
+  SECTION("Capacity is limited by the niches")
+  {
+    using SmallTraits = zxshady::tombstone_range_pattern<std::uint8_t{250}, std::uint8_t{255}>;
+    REQUIRE_THROWS_AS((zxshady::tombstone_pool<std::uint8_t, SmallTraits>(5)), std::length_error);
+    zxshady::tombstone_pool<std::uint8_t, SmallTraits> pool(4);
+    for (std::uint8_t i = 0; i < 4; ++i)
+      REQUIRE(pool.create(i));
+  }
+
+  SECTION("Non trivial objects")
+  {
+    SessionPool pool(16);
+    Session*    a = pool.create(1u, std::string(50, 'a'));
+    REQUIRE_THROWS_AS(pool.create(2u, "throw"), std::runtime_error);
+    Session* b = pool.create(3u, std::string(50, 'b'));
+    REQUIRE(pool.index_of(b) == 1);
+    REQUIRE(pool.size() == 2);
+    pool.destroy(a);
+
+    SessionPool moved = std::move(pool);
+    std::vector<std::string> names;
+    moved.for_each_live([&](const Session& s) { names.push_back(s.name); });
+    REQUIRE(names == std::vector<std::string>{std::string(50, 'b')});
+  }
+}
@@ -0,0 +1,140 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <zxshady/presence.hpp>
+
+namespace {
+template<typename Optional>
+std::vector<Optional> Sparse(std::size_t count, unsigned seed, auto make_value)
+{
+  std::mt19937          rng(seed);
+  std::vector<Optional> v(count);
+  for (std::size_t i = 0; i < count; ++i)
+    if (rng() % 3 == 0)
+      v[i] = make_value(i);
+  return v;
+}
+
+template<typename Optional>
+void CheckAgainstScalar(const std::vector<Optional>& v)
+{
+  std::size_t present       = 0;
+  std::size_t first_present = v.size();
+  std::size_t first_null    = v.size();
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    if (v[i].has_value()) {
+      ++present;
+      first_present = std::min(first_present, i);
+    }
+    else {
+      first_null = std::min(first_null, i);
+    }
+  }
+  REQUIRE(zxshady::count_present(v) == present);
+  REQUIRE(zxshady::find_first_present(v) == first_present);
+  REQUIRE(zxshady::find_first_null(v) == first_null);
+
+  std::vector<std::uint64_t> bitmap((v.size() + 63) / 64, ~std::uint64_t{0});
+  zxshady::to_presence_bitmap(v, bitmap.data());
+  for (std::size_t i = 0; i < bitmap.size() * 64; ++i) {
+    const bool bit = (bitmap[i / 64] >> (i % 64)) & 1;
+    REQUIRE(bit == (i < v.size() && v[i].has_value()));
+  }
+}
+
+template<typename Optional>
+void CheckSizes(auto make_value)
+{
+  for (std::size_t count : {0, 1, 63, 64, 65, 200, 1000})
+    CheckAgainstScalar(Sparse<Optional>(count, static_cast<unsigned>(count), make_value));
+
+  // the answer is past the first few blocks
+  std::vector<Optional> v(500);
+  REQUIRE(zxshady::find_first_present(v) == 500);
+  v[300] = make_value(300);
+  REQUIRE(zxshady::find_first_present(v) == 300);
+  REQUIRE(zxshady::count_present(v) == 1);
+}
+
+int g_objects[1000];
+} // namespace
+
+TEST_CASE("Presence kernels", "[presence]")
+{
+  SECTION("1 byte")
+  {
+    CheckSizes<zxshady::tombstone_optional<bool>>([](std::size_t i) { return i % 2 == 0; });
+  }
+  SECTION("2 bytes")
+  {
+    CheckSizes<zxshady::tombstone_optional<std::uint16_t, zxshady::tombstone_max_traits<std::uint16_t>>>(
+      [](std::size_t i) { return static_cast<std::uint16_t>(i); });
+  }
+  SECTION("4 bytes")
+  {
+    CheckSizes<zxshady::tombstone_optional<std::int32_t, zxshady::tombstone_min_traits<std::int32_t>>>(
+      [](std::size_t i) { return static_cast<std::int32_t>(i); });
+    CheckSizes<zxshady::tombstone_optional<float>>([](std::size_t i) { return static_cast<float>(i); });
+  }
+  SECTION("8 bytes")
+  {
+    CheckSizes<zxshady::tombstone_optional<double>>([](std::size_t i) { return static_cast<double>(i) - 10.0; });
+    CheckSizes<zxshady::tombstone_optional<int*>>([](std::size_t i) { return &g_objects[i]; });
+  }
+  SECTION("Without a bit pattern")
+  {
+    CheckSizes<zxshady::tombstone_optional<std::string, DefaultConstructorInterface>>(
+      [](std::size_t i) { return std::string(i + 1, 'a'); });
+  }
+}
+
+#if ZXSHADY_OPTIONAL_PRESENCE_X86
+namespace {
+template<std::size_t Size>
+void CheckKernels()
+{
+  using namespace zxshady::presence_details;
+  using bits_type = typename zxshady::tombstone_optional_details::UnsignedOfSize<Size>::type;
+
+  constexpr std::size_t  blocks  = 5;
+  constexpr auto         pattern = static_cast<bits_type>(~bits_type{0} - 1);
+  std::vector<bits_type> bits(64 * blocks, pattern);
+  bits[64 + 7] = bits[64 * 3 + 1] = bits[64 * 4 + 63] = 1;
+  const auto* const p = reinterpret_cast<const unsigned char*>(bits.data());
+
+  const auto check = [&](auto count_nulls, auto first_present, auto first_null, auto bitmap) {
+    REQUIRE(count_nulls(p, blocks, pattern, nullptr) == 64 * blocks - 3);
+    REQUIRE(first_present(p, blocks, pattern, nullptr) == 64 + 7);
+    REQUIRE(first_null(p, blocks, pattern, nullptr) == 0);
+    std::uint64_t words[blocks];
+    bitmap(p, blocks, pattern, words);
+    REQUIRE(words[0] == 0);
+    REQUIRE(words[1] == std::uint64_t{1} << 7);
+    REQUIRE(words[4] == std::uint64_t{1} << 63);
+  };
+  check(&ScanSse2<Scan::CountNulls, Size>,
+        &ScanSse2<Scan::FirstPresent, Size>,
+        &ScanSse2<Scan::FirstNull, Size>,
+        &ScanSse2<Scan::Bitmap, Size>);
+  if (__builtin_cpu_supports("avx2"))
+    check(&ScanAvx2<Scan::CountNulls, Size>,
+          &ScanAvx2<Scan::FirstPresent, Size>,
+          &ScanAvx2<Scan::FirstNull, Size>,
+          &ScanAvx2<Scan::Bitmap, Size>);
+  if (__builtin_cpu_supports("avx512bw"))
+    check(&ScanAvx512<Scan::CountNulls, Size>,
+          &ScanAvx512<Scan::FirstPresent, Size>,
+          &ScanAvx512<Scan::FirstNull, Size>,
+          &ScanAvx512<Scan::Bitmap, Size>);
+}
+} // namespace
+
+TEST_CASE("Presence kernels agree on every instruction set", "[presence][simd]")
+{
+  CheckKernels<1>();
+  CheckKernels<2>();
+  CheckKernels<4>();
+  CheckKernels<8>();
+}
+#endif
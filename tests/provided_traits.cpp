@@ -0,0 +1,111 @@
+#include "interface.hpp"
+#include <chrono>
+#include <cstdint>
+
+TEST_CASE("Pointer traits", "[provided_traits][pointer]")
+{
+  using Opt = zxshady::tombstone_optional<int*>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(int*));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Opt>);
+
+  int i = 42;
+  Opt o;
+  REQUIRE(!o);
+  o = &i;
+  REQUIRE(o);
+  REQUIRE(**o == 42);
+  o.reset();
+  REQUIRE(!o.has_value());
+
+  constexpr zxshady::tombstone_optional<const char*> c = "constexpr";
+  STATIC_REQUIRE(c.has_value());
+}
+
+TEST_CASE("Integer traits", "[provided_traits][integer]")
+{
+  using MinOpt = zxshady::tombstone_optional<std::int64_t, zxshady::tombstone_min_traits<std::int64_t>>;
+  using MaxOpt = zxshady::tombstone_optional<std::uint32_t, zxshady::tombstone_max_traits<std::uint32_t>>;
+  STATIC_REQUIRE(sizeof(MinOpt) == sizeof(std::int64_t));
+  STATIC_REQUIRE(sizeof(MaxOpt) == sizeof(std::uint32_t));
+
+  constexpr MinOpt a;
+  constexpr MinOpt b = std::int64_t{0};
+  STATIC_REQUIRE(!a.has_value());
+  STATIC_REQUIRE(*b == 0);
+
+  MaxOpt c = 0u;
+  REQUIRE(c);
+  c = std::nullopt;
+  REQUIRE(!c);
+  c = 7u;
+  REQUIRE(*c == 7u);
+}
+
+TEST_CASE("std::byte traits", "[provided_traits][byte]")
+{
+  using Opt = zxshady::tombstone_optional<std::byte, zxshady::tombstone_max_traits<std::byte>>;
+  STATIC_REQUIRE(sizeof(Opt) == 1);
+
+  constexpr Opt a;
+  constexpr Opt b = std::byte{0};
+  STATIC_REQUIRE(!a);
+  STATIC_REQUIRE(b);
+
+  constexpr zxshady::tombstone_optional<std::byte, zxshady::tombstone_min_traits<std::byte>> c = std::byte{0xff};
+  STATIC_REQUIRE(c);
+  STATIC_REQUIRE(zxshady::tombstone_min_traits<std::byte>::null_value == std::byte{0});
+}
+
+TEST_CASE("Chrono traits", "[provided_traits][chrono]")
+{
+  using Duration  = std::chrono::nanoseconds;
+  using TimePoint = std::chrono::steady_clock::time_point;
+  STATIC_REQUIRE(sizeof(zxshady::tombstone_optional<Duration>) == sizeof(Duration));
+  STATIC_REQUIRE(sizeof(zxshady::tombstone_optional<TimePoint>) == sizeof(TimePoint));
+
+  constexpr zxshady::tombstone_optional<Duration> d = Duration{5};
+  STATIC_REQUIRE(*d == Duration{5});
+  STATIC_REQUIRE(!zxshady::tombstone_optional<Duration>{}.has_value());
+
+  zxshady::tombstone_optional<TimePoint> t;
+  REQUIRE(!t);
+  t = TimePoint{};
+  REQUIRE(t);
+  REQUIRE(*t == TimePoint{});
+}
+
+TEST_CASE("Floating point traits", "[provided_traits][float]")
+{
+  using DoubleOpt = zxshady::tombstone_optional<double>;
+  using FloatOpt  = zxshady::tombstone_optional<float>;
+  STATIC_REQUIRE(sizeof(DoubleOpt) == sizeof(double));
+  STATIC_REQUIRE(sizeof(FloatOpt) == sizeof(float));
+
+  constexpr DoubleOpt a;
+  constexpr DoubleOpt b = 1.5;
+  STATIC_REQUIRE(!a);
+  STATIC_REQUIRE(*b == 1.5);
+
+  SECTION("Ordinary NaNs are values")
+  {
+    DoubleOpt d = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE(d);
+    d = std::numeric_limits<double>::signaling_NaN();
+    REQUIRE(d);
+    d = -std::numeric_limits<double>::quiet_NaN();
+    REQUIRE(d);
+
+    FloatOpt f = std::numeric_limits<float>::quiet_NaN();
+    REQUIRE(f);
+    f = std::numeric_limits<float>::infinity();
+    REQUIRE(f);
+  }
+
+  SECTION("reset")
+  {
+    FloatOpt f = 0.f;
+    REQUIRE(f);
+    f.reset();
+    REQUIRE(!f);
+  }
+}
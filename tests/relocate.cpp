@@ -0,0 +1,159 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <zxshady/container_traits.hpp>
+#include <zxshady/handle_traits.hpp>
+#include <zxshady/relocate.hpp>
+
+namespace {
+struct NotRelocatableTraits {
+  static constexpr bool trivially_relocatable = false;
+  static bool           is_null(int* const& x) noexcept { return x == nullptr; }
+  static void           initialize_null_state(int*& x) noexcept { x = nullptr; }
+};
+
+// counts live objects, the move constructor throws and copying throws once `fail_copy` is set
+struct ThrowingMove {
+  static inline int  live      = 0;
+  static inline bool fail_copy = false;
+
+  int value;
+
+  explicit ThrowingMove(int v) : value(v) { ++live; }
+  ThrowingMove(ThrowingMove&& that) : value(that.value)
+  {
+    if (value == 2)
+      throw std::runtime_error("move");
+    ++live;
+  }
+  ThrowingMove(const ThrowingMove& that) : value(that.value)
+  {
+    if (fail_copy)
+      throw std::runtime_error("copy");
+    ++live;
+  }
+  ~ThrowingMove() { --live; }
+};
+} // namespace
+
+TEST_CASE("is_trivially_relocatable", "[relocate][traits]")
+{
+  using zxshady::is_trivially_relocatable_v;
+  using zxshady::tombstone_optional;
+
+  STATIC_REQUIRE(is_trivially_relocatable_v<int>);
+  STATIC_REQUIRE(is_trivially_relocatable_v<std::unique_ptr<int>>);
+  STATIC_REQUIRE(is_trivially_relocatable_v<std::shared_ptr<int>>);
+  STATIC_REQUIRE(is_trivially_relocatable_v<tombstone_optional<int*>>);
+  STATIC_REQUIRE(is_trivially_relocatable_v<tombstone_optional<std::unique_ptr<int>>>);
+  STATIC_REQUIRE(is_trivially_relocatable_v<tombstone_optional<std::shared_ptr<int>>>);
+  STATIC_REQUIRE(!is_trivially_relocatable_v<tombstone_optional<int*, NotRelocatableTraits>>);
+  STATIC_REQUIRE(is_trivially_relocatable_v<tombstone_optional<std::string>> ==
+                 is_trivially_relocatable_v<std::string>);
+}
+
+TEST_CASE("relocate_at", "[relocate]")
+{
+  using Opt = zxshady::tombstone_optional<std::unique_ptr<int>>;
+
+  alignas(Opt) unsigned char source_storage[sizeof(Opt)];
+  alignas(Opt) unsigned char dest_storage[sizeof(Opt)];
+  Opt* const source = std::construct_at(reinterpret_cast<Opt*>(source_storage), std::make_unique<int>(42));
+  Opt* const dest   = zxshady::relocate_at(source, reinterpret_cast<Opt*>(dest_storage));
+  REQUIRE(*dest->value() == 42);
+  std::destroy_at(dest);
+}
+
+TEST_CASE("relocating_vector", "[relocate][vector]")
+{
+  SECTION("Sizes past max_size")
+  {
+    zxshady::relocating_vector<int> v{1, 2, 3};
+    REQUIRE_THROWS_AS(v.reserve(v.max_size() + 1), std::length_error);
+    REQUIRE_THROWS_AS(v.append_uninitialized(SIZE_MAX, [](int*) {}), std::length_error);
+    REQUIRE(v.size() == 3);
+    REQUIRE(v.back() == 3);
+  }
+
+  SECTION("Trivially relocatable elements")
+  {
+    zxshady::relocating_vector<zxshady::tombstone_optional<std::unique_ptr<int>>> v;
+    for (int i = 0; i < 100; ++i) {
+      if (i % 3 == 0)
+        v.emplace_back();
+      else
+        v.emplace_back(std::make_unique<int>(i));
+    }
+    REQUIRE(v.size() == 100);
+    REQUIRE(!v[0]);
+    REQUIRE(**v[1] == 1);
+    REQUIRE(**v[98] == 98);
+    REQUIRE(!v[99]);
+  }
+
+  SECTION("Other elements")
+  {
+    zxshady::relocating_vector<OptString> v;
+    for (int i = 0; i < 100; ++i) {
+      if (i % 2 == 0)
+        v.emplace_back();
+      else
+        v.emplace_back(std::to_string(i) + " is a string long enough to not fit in the small buffer");
+    }
+    REQUIRE(v.size() == 100);
+    REQUIRE(!v[0]);
+    REQUIRE(v[1]->starts_with("1 is"));
+
+    zxshady::relocating_vector<OptString> copy = v;
+    REQUIRE(copy.size() == 100);
+    REQUIRE(*copy[99] == *v[99]);
+
+    v.emplace_back(v[1]);
+    REQUIRE(v.back() == *copy[1]);
+    v.pop_back();
+    v.clear();
+    REQUIRE(v.empty());
+  }
+}
+
+TEST_CASE("relocation with a throwing move", "[relocate][vector]")
+{
+  SECTION("uninitialized_relocate destroys the whole source")
+  {
+    alignas(ThrowingMove) unsigned char source_storage[4 * sizeof(ThrowingMove)];
+    alignas(ThrowingMove) unsigned char dest_storage[4 * sizeof(ThrowingMove)];
+    auto* const source = reinterpret_cast<ThrowingMove*>(source_storage);
+    for (int i = 0; i < 4; ++i)
+      std::construct_at(source + i, i);
+    REQUIRE_THROWS_AS(
+      zxshady::uninitialized_relocate(source, source + 4, reinterpret_cast<ThrowingMove*>(dest_storage)),
+      std::runtime_error);
+    REQUIRE(ThrowingMove::live == 0);
+  }
+
+  SECTION("relocating_vector keeps its elements when growing fails")
+  {
+    {
+      zxshady::relocating_vector<ThrowingMove> v;
+      for (int i = 0; i < 4; ++i)
+        v.emplace_back(i);
+      REQUIRE(v.capacity() == 4);
+
+      // the move can throw so growing copies
+      v.emplace_back(4);
+      REQUIRE(v.size() == 5);
+      REQUIRE(v[2].value == 2);
+
+      ThrowingMove::fail_copy = true;
+      REQUIRE_THROWS_AS(v.reserve(100), std::runtime_error);
+      ThrowingMove::fail_copy = false;
+      REQUIRE(v.size() == 5);
+      for (int i = 0; i < 5; ++i)
+        REQUIRE(v[static_cast<std::size_t>(i)].value == i);
+      REQUIRE(ThrowingMove::live == 5);
+    }
+    REQUIRE(ThrowingMove::live == 0);
+  }
+}
@@ -0,0 +1,101 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <zxshady/handle_traits.hpp>
+#include <zxshady/slot_map.hpp>
+
+namespace {
+using Map = zxshady::tombstone_slot_map<std::int32_t, zxshady::tombstone_min_traits<std::int32_t>>;
+} // namespace
+
+TEST_CASE("tombstone_slot_map", "[slot_map]")
+{
+  STATIC_REQUIRE(sizeof(zxshady::tombstone_slot_handle) == sizeof(std::uint64_t));
+
+  SECTION("Insert, get and erase")
+  {
+    Map        map;
+    const auto a = map.insert(1);
+    const auto b = map.insert(2);
+    const auto c = map.emplace(3);
+    REQUIRE(map.size() == 3);
+    REQUIRE(map[b] == 2);
+    REQUIRE(*map.get(c) == 3);
+
+    REQUIRE(map.erase(b));
+    REQUIRE(!map.erase(b));
+    REQUIRE(!map.contains(b));
+    REQUIRE(map.get(b) == nullptr);
+    REQUIRE(map.size() == 2);
+
+    // the slot is reused with a new generation so the old handle stays invalid
+    const auto d = map.insert(4);
+    REQUIRE(d.index == b.index);
+    REQUIRE(d != b);
+    REQUIRE(!map.contains(b));
+    REQUIRE(map[d] == 4);
+    REQUIRE(map[a] == 1);
+    REQUIRE(map.slot_count() == 3);
+
+    REQUIRE(zxshady::tombstone_slot_handle::from_bits(d.bits()) == d);
+  }
+
+  SECTION("Erased slots are reused last in, first out")
+  {
+    Map                                        map;
+    std::vector<zxshady::tombstone_slot_handle> handles;
+    for (std::int32_t i = 0; i < 10; ++i)
+      handles.push_back(map.insert(i));
+    map.erase(handles[3]);
+    map.erase(handles[7]);
+    map.erase(handles[5]);
+    REQUIRE(map.insert(0).index == 5);
+    REQUIRE(map.insert(0).index == 7);
+    REQUIRE(map.insert(0).index == 3);
+    REQUIRE(map.insert(0).index == 10);
+  }
+
+  SECTION("Iteration skips erased slots")
+  {
+    Map                                        map;
+    std::vector<zxshady::tombstone_slot_handle> handles;
+    for (std::int32_t i = 0; i < 1000; ++i)
+      handles.push_back(map.insert(i));
+    for (std::size_t i = 0; i < 1000; ++i)
+      if (i % 100 != 42)
+        map.erase(handles[i]);
+
+    std::vector<std::int32_t> values;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+      REQUIRE(it.get_handle() == handles[static_cast<std::size_t>(*it)]);
+      values.push_back(*it);
+    }
+    REQUIRE(values.size() == 10);
+    REQUIRE(values.front() == 42);
+    REQUIRE(values.back() == 942);
+
+    for (auto it = map.begin(); it != map.end();)
+      it = *it < 500 ? map.erase(it) : std::next(it);
+    REQUIRE(map.size() == 5);
+
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE(map.begin() == map.end());
+    for (const auto h : handles)
+      REQUIRE(!map.contains(h));
+  }
+
+  SECTION("Non trivial values")
+  {
+    zxshady::tombstone_slot_map<std::unique_ptr<std::string>> map;
+    const auto a = map.insert(std::make_unique<std::string>(40, 'a'));
+    const auto b = map.insert(std::make_unique<std::string>(40, 'b'));
+    map.erase(a);
+    for (int i = 0; i < 100; ++i)
+      map.insert(std::make_unique<std::string>(40, 'c'));
+    REQUIRE(*map[b] == std::string(40, 'b'));
+    REQUIRE(map.size() == 101);
+  }
+}
@@ -0,0 +1,88 @@
+#include "interface.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <zxshady/sort.hpp>
+
+namespace {
+using MinInt = zxshady::tombstone_optional<std::int32_t, zxshady::tombstone_min_traits<std::int32_t>>;
+using MaxU64 = zxshady::tombstone_optional<std::uint64_t, zxshady::tombstone_max_traits<std::uint64_t>>;
+using MidInt = zxshady::tombstone_optional<std::int16_t, zxshady::tombstone_value_pattern<std::int16_t{7}>>;
+using OptDbl = zxshady::tombstone_optional<double>;
+
+template<typename Optional>
+std::vector<Optional> Random(std::size_t count, auto make_value)
+{
+  std::mt19937          rng(42);
+  std::vector<Optional> v(count);
+  for (auto& o : v)
+    if (rng() % 4 != 0)
+      o = make_value(rng);
+  return v;
+}
+
+template<typename Optional>
+void CheckRadixSort(std::vector<Optional> v)
+{
+  std::vector<Optional> expected = v;
+  std::ranges::stable_sort(expected, std::ranges::less{});
+  zxshady::radix_sort(v);
+  REQUIRE(v.size() == expected.size());
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    REQUIRE(v[i].has_value() == expected[i].has_value());
+    if (v[i])
+      REQUIRE(*v[i] == *expected[i]);
+  }
+}
+} // namespace
+
+TEST_CASE("Null ordering traits", "[sort][traits]")
+{
+  STATIC_REQUIRE(zxshady::tombstone_min_traits<int>::null_orders_first);
+  STATIC_REQUIRE(!zxshady::tombstone_min_traits<int>::null_orders_last);
+  STATIC_REQUIRE(zxshady::tombstone_max_traits<unsigned>::null_orders_last);
+  STATIC_REQUIRE(!zxshady::tombstone_value_pattern<-1>::null_orders_first);
+  STATIC_REQUIRE(zxshady::tombstone_range_pattern<std::numeric_limits<int>::min(), -100>::null_orders_first);
+
+  constexpr MinInt null;
+  constexpr MinInt a = -5;
+  constexpr MinInt b = 3;
+  STATIC_REQUIRE((null <=> a) == std::strong_ordering::less);
+  STATIC_REQUIRE((b <=> null) == std::strong_ordering::greater);
+  STATIC_REQUIRE((null <=> MinInt()) == std::strong_ordering::equal);
+  STATIC_REQUIRE(a < b);
+}
+
+TEST_CASE("partition_nulls", "[sort][partition]")
+{
+  std::vector<MidInt> v = {
+    MidInt(std::int16_t{1}), MidInt(), MidInt(std::int16_t{2}), MidInt(), MidInt(std::int16_t{3})};
+  const auto          values = zxshady::partition_nulls(v);
+  REQUIRE(values.size() == 3);
+  REQUIRE(!v[0]);
+  REQUIRE(!v[1]);
+  REQUIRE(std::ranges::all_of(values, [](const MidInt& o) { return o.has_value(); }));
+}
+
+TEST_CASE("radix_sort", "[sort][radix]")
+{
+  CheckRadixSort(Random<MinInt>(1000, [](auto& rng) { return static_cast<std::int32_t>(rng()) / 2; }));
+  CheckRadixSort(Random<MaxU64>(1000, [](auto& rng) { return std::uint64_t{rng()} << (rng() % 32); }));
+  CheckRadixSort(Random<MidInt>(1000, [](auto& rng) { return static_cast<std::int16_t>(rng() % 1000 + 8); }));
+  CheckRadixSort(Random<OptDbl>(1000, [](auto& rng) { return static_cast<double>(static_cast<int>(rng() % 2001) - 1000) / 8; }));
+  CheckRadixSort(std::vector<MinInt>(10));
+  CheckRadixSort(std::vector<MinInt>{});
+}
+
+TEST_CASE("lower_bound_present", "[sort][binary_search]")
+{
+  std::vector<MinInt> a = {MinInt(), MinInt(), 1, 3, 3, 7};
+  REQUIRE(zxshady::lower_bound_present(a, 0) - a.begin() == 2);
+  REQUIRE(zxshady::lower_bound_present(a, 3) - a.begin() == 3);
+  REQUIRE(zxshady::lower_bound_present(a, 8) == a.end());
+
+  std::vector<MidInt> b = {MidInt(), MidInt(std::int16_t{1}), MidInt(std::int16_t{3}), MidInt(std::int16_t{10})};
+  REQUIRE(zxshady::lower_bound_present(b, std::int16_t{2}) - b.begin() == 2);
+  REQUIRE(zxshady::lower_bound_present(b, std::int16_t{-100}) - b.begin() == 1);
+}
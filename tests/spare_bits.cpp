@@ -0,0 +1,52 @@
+#include "interface.hpp"
+#include <cstdint>
+
+TEST_CASE("Pointer alignment bits", "[spare_bits][pointer]")
+{
+  using Traits = zxshady::tombstone_alignment_bits<std::uint64_t>;
+  using Opt    = zxshady::tombstone_optional<std::uint64_t*, Traits>;
+  STATIC_REQUIRE(sizeof(Opt) == sizeof(void*));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Opt>);
+  STATIC_REQUIRE(Traits::niche_count == alignof(std::uint64_t) - 1);
+
+  std::uint64_t x = 42;
+
+  Opt o;
+  REQUIRE(!o);
+  o = nullptr;
+  REQUIRE(o.has_value());
+  REQUIRE(*o == nullptr);
+  o = &x;
+  REQUIRE(**o == 42);
+  o.reset();
+  REQUIRE(!o);
+
+  std::uint64_t* p = nullptr;
+  Traits::initialize_niche(p, 2);
+  REQUIRE(Traits::niche_index(p) == 2);
+  REQUIRE(Traits::niche_index(&x) == Traits::niche_count);
+  REQUIRE(Traits::niche_index(nullptr) == Traits::niche_count);
+}
+
+TEST_CASE("High bits of a bounded integer", "[spare_bits][integer]")
+{
+  using Index48 = zxshady::tombstone_spare_bits<std::uint64_t, 0xffff'0000'0000'0000>;
+  using Opt     = zxshady::tombstone_optional<std::uint64_t, Index48>;
+  STATIC_REQUIRE(Index48::niche_count == 0xffff);
+
+  constexpr Opt null;
+  constexpr Opt zero = std::uint64_t{0};
+  constexpr Opt max  = std::uint64_t{0x0000'ffff'ffff'ffff};
+  STATIC_REQUIRE(!null);
+  STATIC_REQUIRE(*zero == 0);
+  STATIC_REQUIRE(*max == 0x0000'ffff'ffff'ffff);
+
+  STATIC_REQUIRE(Index48::niche_index(0x0001'0000'0000'0000) == 0);
+  STATIC_REQUIRE(Index48::niche_index(0xffff'0000'0000'0000) == 0xfffe);
+  STATIC_REQUIRE(Index48::niche_index(0x0001'0000'0000'0001) == Index48::niche_count);
+
+  using Opt2 = zxshady::tombstone_optional<Opt>;
+  STATIC_REQUIRE(sizeof(Opt2) == sizeof(std::uint64_t));
+  constexpr Opt2 nested = Opt{};
+  STATIC_REQUIRE(nested && !*nested);
+}
@@ -0,0 +1,112 @@
+#include "interface.hpp"
+#include <cstdint>
+#include <string>
+#include <zxshady/container_traits.hpp>
+#include <zxshady/variant.hpp>
+
+namespace {
+struct Pending {};
+struct Deleted {};
+struct Absent {};
+
+using Niches  = zxshady::tombstone_range_pattern<std::uint32_t{0xffff'fffd}, std::uint32_t{0xffff'ffff}>;
+using Message = zxshady::basic_tombstone_variant<std::uint32_t, Niches, Pending, Deleted, Absent>;
+
+struct Name {
+  constexpr std::size_t operator()(std::uint32_t) const noexcept { return 0; }
+  constexpr std::size_t operator()(Pending) const noexcept { return 1; }
+  constexpr std::size_t operator()(Deleted) const noexcept { return 2; }
+  constexpr std::size_t operator()(Absent) const noexcept { return 3; }
+};
+} // namespace
+
+TEST_CASE("tombstone_variant", "[variant]")
+{
+  STATIC_REQUIRE(sizeof(Message) == sizeof(std::uint32_t));
+  STATIC_REQUIRE(std::is_trivially_copyable_v<Message>);
+
+  SECTION("constexpr")
+  {
+    constexpr Message a;
+    constexpr Message b = Deleted{};
+    constexpr Message c = 42u;
+
+    STATIC_REQUIRE(a.index() == 1);
+    STATIC_REQUIRE(a.holds_alternative<Pending>());
+    STATIC_REQUIRE(b.index() == 2);
+    STATIC_REQUIRE(zxshady::holds_alternative<Deleted>(b));
+    STATIC_REQUIRE(c.index() == 0);
+    STATIC_REQUIRE(*c == 42u);
+    STATIC_REQUIRE(c.visit(Name{}) == 0);
+    STATIC_REQUIRE(b.visit(Name{}) == 2);
+  }
+
+  SECTION("Assignment")
+  {
+    Message m = 7u;
+    REQUIRE(m.holds_value());
+    m = Absent{};
+    REQUIRE(m.index() == 3);
+    REQUIRE(zxshady::visit(Name{}, m) == 3);
+    REQUIRE(m.get_if() == nullptr);
+    m = 0u;
+    REQUIRE(m.value() == 0u);
+    m.emplace<Pending>();
+    REQUIRE(m.holds_alternative<Pending>());
+    REQUIRE(m == Message{Pending{}});
+    REQUIRE(m != Message{1u});
+  }
+
+  SECTION("visit with void")
+  {
+    const Message m     = 5u;
+    std::uint32_t found = 0;
+    m.visit([&](const auto& x) {
+      if constexpr (std::is_same_v<std::remove_cvref_t<decltype(x)>, std::uint32_t>)
+        found = x;
+    });
+    REQUIRE(found == 5u);
+  }
+}
+
+TEST_CASE("tombstone_variant with a non trivial type", "[variant]")
+{
+  using Var = zxshady::tombstone_variant<std::string, Absent>;
+  STATIC_REQUIRE(sizeof(Var) == sizeof(std::string));
+
+  Var v;
+  REQUIRE(v.holds_alternative<Absent>());
+  v = std::string("a string long enough to not fit in the small buffer");
+  REQUIRE(v->size() == 51);
+
+  Var copy = v;
+  REQUIRE(copy == v);
+  v = Absent{};
+  swap(v, copy);
+  REQUIRE(v.holds_value());
+  REQUIRE(copy.index() == 1);
+  swap(v, copy);
+  REQUIRE(v.index() == 1);
+  REQUIRE(copy->size() == 51);
+
+  Var other = std::string("other");
+  swap(copy, other);
+  REQUIRE(*copy == "other");
+  REQUIRE(other->size() == 51);
+  swap(v, v);
+  REQUIRE(v.holds_alternative<Absent>());
+}
+
+TEST_CASE("tombstone_variant swap of empty alternatives", "[variant]")
+{
+  Message a = Pending{};
+  Message b = Absent{};
+  swap(a, b);
+  REQUIRE(a.holds_alternative<Absent>());
+  REQUIRE(b.holds_alternative<Pending>());
+
+  Message c = 7u;
+  swap(a, c);
+  REQUIRE(*a == 7u);
+  REQUIRE(c.holds_alternative<Absent>());
+}
@@ -0,0 +1,129 @@
+#include "interface.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <vector>
+#include <zxshady/column.hpp>
+#include <zxshady/views.hpp>
+
+namespace {
+using OptInt = zxshady::tombstone_optional<int, zxshady::tombstone_min_traits<int>>;
+}
+
+TEST_CASE("views::present", "[views][present]")
+{
+  SECTION("Contiguous")
+  {
+    std::vector<OptInt> v(300);
+    v[0]   = 1;
+    v[2]   = 2;
+    v[200] = 3;
+    v[299] = 4;
+
+    STATIC_REQUIRE(std::ranges::forward_range<decltype(v | zxshady::views::present)>);
+    STATIC_REQUIRE(std::is_same_v<std::ranges::range_reference_t<decltype(v | zxshady::views::present)>, int&>);
+    REQUIRE(std::ranges::equal(v | zxshady::views::present, std::vector<int>{1, 2, 3, 4}));
+
+    for (int& x : v | zxshady::views::present)
+      x *= 10;
+    REQUIRE(*v[200] == 30);
+
+    const std::vector<OptInt>& cv = v;
+    STATIC_REQUIRE(std::is_same_v<std::ranges::range_reference_t<decltype(cv | zxshady::views::present)>, const int&>);
+    REQUIRE(std::ranges::count_if(cv | zxshady::views::present, [](int x) { return x > 15; }) == 3);
+
+    std::vector<OptInt> empty(100);
+    REQUIRE(std::ranges::empty(zxshady::views::present(empty)));
+  }
+
+  SECTION("Composes with other views")
+  {
+    std::vector<OptInt> v(10);
+    for (int i = 0; i < 10; i += 2)
+      v[static_cast<std::size_t>(i)] = i;
+    auto first_three = v | zxshady::views::present | std::views::take(3);
+    REQUIRE(std::ranges::equal(first_three, std::vector<int>{0, 2, 4}));
+    REQUIRE(std::ranges::equal(v | std::views::drop(5) | zxshady::views::present, std::vector<int>{6, 8}));
+  }
+
+  SECTION("Not contiguous")
+  {
+    std::list<OptString> l;
+    l.emplace_back("a");
+    l.emplace_back();
+    l.emplace_back("b");
+    REQUIRE(std::ranges::equal(l | zxshady::views::present, std::vector<std::string>{"a", "b"}));
+  }
+
+  SECTION("Moves do not keep the cached begin")
+  {
+    // the owning view stores the array, so its first value must be inside the view
+    const auto points_into = [](const auto& view, const int* p) {
+      const auto first = reinterpret_cast<std::uintptr_t>(std::addressof(view));
+      const auto at    = reinterpret_cast<std::uintptr_t>(p);
+      return at >= first && at < first + sizeof(view);
+    };
+
+    std::array<OptInt, 4> a{};
+    a[1] = 1;
+    a[3] = 3;
+    auto view = std::move(a) | zxshady::views::present;
+    REQUIRE(*view.begin() == 1);
+
+    auto moved = std::move(view);
+    REQUIRE(points_into(moved, &*moved.begin()));
+    REQUIRE(std::ranges::equal(moved, std::vector<int>{1, 3}));
+
+    std::array<OptInt, 4> b{};
+    b[2] = 2;
+    auto other = std::move(b) | zxshady::views::present;
+    REQUIRE(*other.begin() == 2);
+    other = std::move(moved);
+    REQUIRE(points_into(other, &*other.begin()));
+    REQUIRE(std::ranges::equal(other, std::vector<int>{1, 3}));
+  }
+
+  SECTION("Column")
+  {
+    zxshady::tombstone_column<int, zxshady::tombstone_min_traits<int>> c;
+    c.push_back(5);
+    c.push_back_null(70);
+    c.push_back(6);
+    REQUIRE(std::ranges::equal(c | zxshady::views::present, std::vector<int>{5, 6}));
+  }
+}
+
+TEST_CASE("views::values_or", "[views][values_or]")
+{
+  std::vector<OptInt> v(100);
+  for (int i = 0; i < 100; i += 3)
+    v[static_cast<std::size_t>(i)] = i;
+
+  auto values = v | zxshady::views::values_or(-1);
+  STATIC_REQUIRE(std::ranges::random_access_range<decltype(values)>);
+  REQUIRE(values[0] == 0);
+  REQUIRE(values[1] == -1);
+  REQUIRE(values[99] == 99);
+
+  const auto sum = std::accumulate(values.begin(), values.end(), 0);
+  int        expected = 0;
+  for (int i = 0; i < 100; ++i)
+    expected += i % 3 == 0 ? i : -1;
+  REQUIRE(sum == expected);
+
+  std::vector<zxshady::tombstone_optional<double>> d(3);
+  d[1] = 2.5;
+  REQUIRE(std::ranges::equal(d | zxshady::views::values_or(0.0), std::vector<double>{0.0, 2.5, 0.0}));
+
+  std::vector<zxshady::tombstone_optional<bool>> b(2);
+  b[0] = true;
+  REQUIRE(std::ranges::equal(b | zxshady::views::values_or(false), std::vector<bool>{true, false}));
+
+  std::vector<OptString> s(2);
+  s[1] = "x";
+  REQUIRE(std::ranges::equal(s | zxshady::views::values_or("none"), std::vector<std::string>{"none", "x"}));
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <zxshady/optional.hpp>
+#include <zxshady/presence.hpp>
+
+namespace zxshady {
+
+namespace array_details {
+  struct NoBitmap {};
+} // namespace array_details
+
+// `N` slots that are each empty or hold a `T`, with the number of values kept up to date.
+// Up to 64 slots also keep a bitmap of the values so `first_free` and `next_present` are a bit scan,
+// larger arrays scan the slots with the presence kernels. It is trivially copyable when the slots are.
+template<typename T, std::size_t N, typename Traits = tombstone_traits<T>>
+class tombstone_array {
+public:
+  using value_type    = T;
+  using traits_type   = Traits;
+  using optional_type = tombstone_optional<T, Traits>;
+  using size_type     = std::size_t;
+
+  static constexpr bool uses_bitmap = N <= 64;
+private:
+  using bitmap_type = std::conditional_t<uses_bitmap, std::uint64_t, array_details::NoBitmap>;
+
+  template<bool Const>
+  class PresentIterator {
+    using array_pointer = std::conditional_t<Const, const tombstone_array*, tombstone_array*>;
+  public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::conditional_t<Const, const T&, T&>;
+
+    constexpr PresentIterator() = default;
+    constexpr PresentIterator(array_pointer array, size_type index) noexcept : mArray(array), mIndex(index) {}
+
+    [[nodiscard]] constexpr reference operator*() const noexcept { return *mArray->mSlots[mIndex]; }
+    [[nodiscard]] constexpr auto      operator->() const noexcept { return std::addressof(**this); }
+
+    // the slot of the current value
+    [[nodiscard]] constexpr size_type index() const noexcept { return mIndex; }
+
+    constexpr PresentIterator& operator++() noexcept
+    {
+      mIndex = mArray->next_present(mIndex + 1);
+      return *this;
+    }
+    constexpr PresentIterator operator++(int) noexcept
+    {
+      PresentIterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(const PresentIterator& a, const PresentIterator& b) noexcept
+    {
+      return a.mIndex == b.mIndex;
+    }
+  private:
+    array_pointer mArray = nullptr;
+    size_type     mIndex = 0;
+  };
+public:
+  using present_iterator       = PresentIterator<false>;
+  using const_present_iterator = PresentIterator<true>;
+
+  constexpr tombstone_array() noexcept = default;
+
+  [[nodiscard]] static constexpr size_type capacity() noexcept { return N; }
+
+  // the number of slots with a value
+  [[nodiscard]] constexpr size_type size() const noexcept { return mSize; }
+  [[nodiscard]] constexpr bool      empty() const noexcept { return mSize == 0; }
+  [[nodiscard]] constexpr bool      full() const noexcept { return mSize == N; }
+
+  // slots are read only so the count stays right, use `emplace` and `reset` to change them
+  [[nodiscard]] constexpr const optional_type& operator[](size_type i) const noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(i < N, "tombstone_array index out of range");
+    return mSlots[i];
+  }
+  [[nodiscard]] constexpr const optional_type* data() const noexcept { return mSlots.data(); }
+
+  [[nodiscard]] constexpr bool contains(size_type i) const noexcept { return i < N && mSlots[i].has_value(); }
+
+  [[nodiscard]] constexpr T& value(size_type i) noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(contains(i), "tombstone_array slot is empty");
+    return *mSlots[i];
+  }
+  [[nodiscard]] constexpr const T& value(size_type i) const noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(contains(i), "tombstone_array slot is empty");
+    return *mSlots[i];
+  }
+
+  // constructs a value in the empty slot `i`
+  template<typename... Args>
+  constexpr T& emplace(size_type i, Args&&... args)
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(i < N && !mSlots[i].has_value(), "tombstone_array slot is not empty");
+    T& value = mSlots[i].emplace(ZXFWD(args)...);
+    ++mSize;
+    if constexpr (uses_bitmap)
+      mBitmap |= std::uint64_t{1} << i;
+    return value;
+  }
+
+  // constructs a value in the first empty slot and returns its index, or `capacity()` when the array is full
+  template<typename... Args>
+  constexpr size_type insert(Args&&... args)
+  {
+    const size_type i = first_free();
+    if (i != N)
+      emplace(i, ZXFWD(args)...);
+    return i;
+  }
+
+  // destroys the value in slot `i` if there is one and returns whether there was
+  constexpr bool reset(size_type i) noexcept
+  {
+    if (!contains(i))
+      return false;
+    mSlots[i].reset();
+    --mSize;
+    if constexpr (uses_bitmap)
+      mBitmap &= ~(std::uint64_t{1} << i);
+    return true;
+  }
+
+  constexpr void clear() noexcept
+  {
+    for (size_type i = next_present(0); i != N; i = next_present(i + 1))
+      mSlots[i].reset();
+    mSize = 0;
+    if constexpr (uses_bitmap)
+      mBitmap = 0;
+  }
+
+  // the index of the first empty slot, or `capacity()` when the array is full
+  [[nodiscard]] constexpr size_type first_free() const noexcept
+  {
+    if (mSize == N)
+      return N;
+    if constexpr (uses_bitmap) {
+      return static_cast<size_type>(std::countr_one(mBitmap));
+    }
+    else {
+      if (std::is_constant_evaluated()) {
+        size_type i = 0;
+        while (mSlots[i].has_value())
+          ++i;
+        return i;
+      }
+      return find_first_null(std::span<const optional_type, N>(mSlots));
+    }
+  }
+
+  // the index of the first slot from `i` with a value, or `capacity()` if there is none
+  [[nodiscard]] constexpr size_type next_present(size_type i) const noexcept
+  {
+    if (i >= N || mSize == 0)
+      return N;
+    if constexpr (uses_bitmap) {
+      const std::uint64_t rest = mBitmap >> i;
+      return rest != 0 ? i + static_cast<size_type>(std::countr_zero(rest)) : N;
+    }
+    else {
+      if (std::is_constant_evaluated()) {
+        while (i != N && !mSlots[i].has_value())
+          ++i;
+        return i;
+      }
+      return i + find_first_present(std::span<const optional_type>(mSlots).subspan(i));
+    }
+  }
+
+  // the values in slot order, empty slots are skipped
+  [[nodiscard]] constexpr std::ranges::subrange<present_iterator> present() noexcept
+  {
+    return {present_iterator(this, next_present(0)), present_iterator(this, N)};
+  }
+  [[nodiscard]] constexpr std::ranges::subrange<const_present_iterator> present() const noexcept
+  {
+    return {const_present_iterator(this, next_present(0)), const_present_iterator(this, N)};
+  }
+private:
+  std::array<optional_type, N>      mSlots{};
+  size_type                         mSize = 0;
+  [[no_unique_address]] bitmap_type mBitmap{};
+};
+
+} // namespace zxshady
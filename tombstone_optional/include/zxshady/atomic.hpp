@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <type_traits>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+// A `tombstone_optional<T, Traits>` that is read and written atomically, it is a `std::atomic<T>` that holds
+// the null state when empty. Compare exchange compares bits, so `Traits::is_null` must only accept the bit
+// pattern `Traits::initialize_null_state` writes.
+template<typename T, typename Traits = tombstone_traits<T>>
+class atomic_tombstone_optional {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable to be used in a std::atomic");
+  static_assert(concepts::tombstone_trivial_destroy_traits_for<Traits, T>,
+                "Traits must not define destroy_null_state, a std::atomic never destroys its value");
+  static_assert(std::atomic<T>::is_always_lock_free, "atomic_tombstone_optional must be lock free");
+public:
+  using value_type    = T;
+  using traits_type   = Traits;
+  using optional_type = tombstone_optional<T, Traits>;
+
+  static constexpr bool is_always_lock_free = true;
+
+  constexpr atomic_tombstone_optional() noexcept : mValue(Null()) {}
+  constexpr atomic_tombstone_optional(std::nullopt_t) noexcept : mValue(Null()) {}
+  constexpr atomic_tombstone_optional(const optional_type& o) noexcept : mValue(Raw(o)) {}
+
+  atomic_tombstone_optional(const atomic_tombstone_optional&)            = delete;
+  atomic_tombstone_optional& operator=(const atomic_tombstone_optional&) = delete;
+
+  [[nodiscard]] bool is_lock_free() const noexcept { return true; }
+
+  [[nodiscard]] optional_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+  {
+    return FromRaw(mValue.load(order));
+  }
+
+  [[nodiscard]] bool has_value(std::memory_order order = std::memory_order_seq_cst) const noexcept
+  {
+    return !Traits::is_null(mValue.load(order));
+  }
+
+  void store(const optional_type& o, std::memory_order order = std::memory_order_seq_cst) noexcept
+  {
+    mValue.store(Raw(o), order);
+  }
+
+  optional_type exchange(const optional_type& o, std::memory_order order = std::memory_order_seq_cst) noexcept
+  {
+    return FromRaw(mValue.exchange(Raw(o), order));
+  }
+
+  // stores `value` only when empty and returns whether it did, the null state is never published
+  bool try_publish(const T& value, std::memory_order order = std::memory_order_seq_cst) noexcept
+  {
+    if (Traits::is_null(value))
+      return false;
+    T expected = Null();
+    return mValue.compare_exchange_strong(expected, value, order, FailureOrder(order));
+  }
+
+  // empties the optional and returns what it held
+  optional_type take(std::memory_order order = std::memory_order_seq_cst) noexcept
+  {
+    return FromRaw(mValue.exchange(Null(), order));
+  }
+
+  // `expected` may be `std::nullopt`, on failure it gets the current value
+  bool compare_exchange_strong(optional_type&       expected,
+                               const optional_type& desired,
+                               std::memory_order    success,
+                               std::memory_order    failure) noexcept
+  {
+    T raw = Raw(expected);
+    if (mValue.compare_exchange_strong(raw, Raw(desired), success, failure))
+      return true;
+    expected = FromRaw(raw);
+    return false;
+  }
+  bool compare_exchange_strong(optional_type&       expected,
+                               const optional_type& desired,
+                               std::memory_order    order = std::memory_order_seq_cst) noexcept
+  {
+    return compare_exchange_strong(expected, desired, order, FailureOrder(order));
+  }
+
+  bool compare_exchange_weak(optional_type&       expected,
+                             const optional_type& desired,
+                             std::memory_order    success,
+                             std::memory_order    failure) noexcept
+  {
+    T raw = Raw(expected);
+    if (mValue.compare_exchange_weak(raw, Raw(desired), success, failure))
+      return true;
+    expected = FromRaw(raw);
+    return false;
+  }
+  bool compare_exchange_weak(optional_type&       expected,
+                             const optional_type& desired,
+                             std::memory_order    order = std::memory_order_seq_cst) noexcept
+  {
+    return compare_exchange_weak(expected, desired, order, FailureOrder(order));
+  }
+
+  // blocks while the optional holds `old` like `std::atomic::wait`
+  void wait(const optional_type& old, std::memory_order order = std::memory_order_seq_cst) const noexcept
+  {
+    mValue.wait(Raw(old), order);
+  }
+
+  // blocks until the optional has a value and returns it
+  optional_type wait_until_present(std::memory_order order = std::memory_order_seq_cst) const noexcept
+  {
+    T raw = mValue.load(order);
+    for (; Traits::is_null(raw); raw = mValue.load(order))
+      mValue.wait(raw, order);
+    return FromRaw(raw);
+  }
+
+  // blocks until the optional is empty
+  void wait_until_empty(std::memory_order order = std::memory_order_seq_cst) const noexcept
+  {
+    for (T raw = mValue.load(order); !Traits::is_null(raw); raw = mValue.load(order))
+      mValue.wait(raw, order);
+  }
+
+  void notify_one() noexcept { mValue.notify_one(); }
+  void notify_all() noexcept { mValue.notify_all(); }
+private:
+  static constexpr T Null() noexcept
+  {
+    const optional_type null;
+    return tombstone_optional_details::Access::Value(null);
+  }
+
+  static constexpr T Raw(const optional_type& o) noexcept { return tombstone_optional_details::Access::Value(o); }
+
+  static constexpr optional_type FromRaw(const T& raw) noexcept
+  {
+    return Traits::is_null(raw) ? optional_type() : optional_type(raw);
+  }
+
+  // the failure order of a compare exchange cannot release
+  static constexpr std::memory_order FailureOrder(std::memory_order order) noexcept
+  {
+    switch (order) {
+    case std::memory_order_acq_rel: return std::memory_order_acquire;
+    case std::memory_order_release: return std::memory_order_relaxed;
+    default: return order;
+    }
+  }
+
+  std::atomic<T> mValue;
+};
+
+} // namespace zxshady
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <zxshady/null_fill.hpp>
+#include <zxshady/optional.hpp>
+#include <zxshady/presence.hpp>
+#include <zxshady/relocate.hpp>
+
+namespace zxshady {
+
+namespace column_details {
+  // hands out storage aligned to `Alignment` so the column starts on a cache line
+  template<typename T, std::size_t Alignment>
+  struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+      using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+    {
+    }
+
+    [[nodiscard]] static constexpr std::size_t max_size() noexcept { return PTRDIFF_MAX / sizeof(T); }
+
+    [[nodiscard]] static T* allocate(std::size_t count)
+    {
+      if (count > max_size())
+        throw std::length_error("tombstone_column is longer than max_size");
+      return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    static void deallocate(T* p, std::size_t) noexcept { ::operator delete(static_cast<void*>(p), std::align_val_t{Alignment}); }
+
+    template<typename U>
+    [[nodiscard]] friend constexpr bool operator==(const AlignedAllocator&, const AlignedAllocator<U, Alignment>&) noexcept
+    {
+      return true;
+    }
+  };
+} // namespace column_details
+
+// A column of nullable values stored as a single cache line aligned array of `tombstone_optional<T, Traits>`,
+// nulls cost exactly `sizeof(T)` and there are no side bitmaps to keep in sync.
+// The storage is a `relocating_vector`, the column only adds the null and bulk operations.
+template<typename T, typename Traits = tombstone_traits<T>>
+class tombstone_column {
+public:
+  using optional_type   = tombstone_optional<T, Traits>;
+  using value_type      = optional_type;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference       = optional_type&;
+  using const_reference = const optional_type&;
+  using iterator        = optional_type*;
+  using const_iterator  = const optional_type*;
+
+  static constexpr std::size_t alignment = std::max<std::size_t>(64, alignof(optional_type));
+private:
+  static_assert(sizeof(optional_type) == sizeof(T));
+
+  using storage_type = relocating_vector<optional_type, column_details::AlignedAllocator<optional_type, alignment>>;
+
+  // values can be copied in with memcpy
+  static constexpr bool bitwise_values = std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<optional_type>;
+
+  template<bool Const>
+  class PresentIterator {
+    using optional_pointer = std::conditional_t<Const, const optional_type*, optional_type*>;
+  public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::conditional_t<Const, const T&, T&>;
+    using pointer           = std::conditional_t<Const, const T*, T*>;
+
+    PresentIterator() = default;
+    PresentIterator(optional_pointer current, optional_pointer last) noexcept : mCurrent(current), mLast(last)
+    {
+      SkipNulls();
+    }
+
+    [[nodiscard]] reference operator*() const noexcept { return **mCurrent; }
+    [[nodiscard]] pointer   operator->() const noexcept { return std::addressof(**mCurrent); }
+
+    PresentIterator& operator++() noexcept
+    {
+      ++mCurrent;
+      SkipNulls();
+      return *this;
+    }
+    PresentIterator operator++(int) noexcept
+    {
+      PresentIterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    [[nodiscard]] friend bool operator==(const PresentIterator& a, const PresentIterator& b) noexcept
+    {
+      return a.mCurrent == b.mCurrent;
+    }
+  private:
+    void SkipNulls() noexcept
+    {
+      while (mCurrent != mLast && !mCurrent->has_value())
+        ++mCurrent;
+    }
+
+    optional_pointer mCurrent = nullptr;
+    optional_pointer mLast    = nullptr;
+  };
+public:
+  using present_iterator       = PresentIterator<false>;
+  using const_present_iterator = PresentIterator<true>;
+
+  tombstone_column() noexcept = default;
+
+  tombstone_column(const tombstone_column& that) : tombstone_column()
+  {
+    append(std::span<const optional_type>(that.data(), that.size()));
+  }
+
+  tombstone_column(tombstone_column&&) noexcept = default;
+
+  tombstone_column& operator=(tombstone_column that) noexcept
+  {
+    swap(*this, that);
+    return *this;
+  }
+
+  [[nodiscard]] iterator       begin() noexcept { return mData.begin(); }
+  [[nodiscard]] const_iterator begin() const noexcept { return mData.begin(); }
+  [[nodiscard]] iterator       end() noexcept { return mData.end(); }
+  [[nodiscard]] const_iterator end() const noexcept { return mData.end(); }
+
+  [[nodiscard]] optional_type*       data() noexcept { return mData.data(); }
+  [[nodiscard]] const optional_type* data() const noexcept { return mData.data(); }
+
+  [[nodiscard]] size_type size() const noexcept { return mData.size(); }
+  [[nodiscard]] size_type capacity() const noexcept { return mData.capacity(); }
+  [[nodiscard]] size_type max_size() const noexcept { return mData.max_size(); }
+  [[nodiscard]] bool      empty() const noexcept { return mData.empty(); }
+
+  // the number of elements with a value
+  [[nodiscard]] size_type size_present() const noexcept
+  {
+    return count_present(std::span<const optional_type>(data(), size()));
+  }
+
+  [[nodiscard]] optional_type& operator[](size_type i) noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(i < size(), "tombstone_column index out of range");
+    return mData[i];
+  }
+  [[nodiscard]] const optional_type& operator[](size_type i) const noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(i < size(), "tombstone_column index out of range");
+    return mData[i];
+  }
+
+  // the values of the column, nulls are skipped
+  [[nodiscard]] std::ranges::subrange<present_iterator> present() noexcept
+  {
+    return {present_iterator(begin(), end()), present_iterator(end(), end())};
+  }
+  [[nodiscard]] std::ranges::subrange<const_present_iterator> present() const noexcept
+  {
+    return {const_present_iterator(begin(), end()), const_present_iterator(end(), end())};
+  }
+
+  void reserve(size_type new_capacity) { mData.reserve(new_capacity); }
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args)
+  {
+    return *mData.emplace_back(std::in_place, ZXFWD(args)...);
+  }
+
+  void push_back(const T& x) { emplace_back(x); }
+  void push_back(T&& x) { emplace_back(std::move(x)); }
+  void push_back(const optional_type& x) { mData.emplace_back(x); }
+
+  void push_back_null(size_type count = 1)
+  {
+    mData.append_uninitialized(count, [count](optional_type* first) { uninitialized_fill_null(first, first + count); });
+  }
+
+  // every element of `values` becomes a present element, `values` may point into the column
+  void append(std::span<const T> values) { Append(values); }
+  void append(std::span<const optional_type> values) { Append(values); }
+
+  void assign(std::span<const T> values)
+  {
+    clear();
+    append(values);
+  }
+  void assign(std::span<const optional_type> values)
+  {
+    clear();
+    append(values);
+  }
+
+  void pop_back() noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!empty(), "pop_back on an empty tombstone_column");
+    mData.pop_back();
+  }
+
+  void clear() noexcept { mData.clear(); }
+
+  friend void swap(tombstone_column& a, tombstone_column& b) noexcept { swap(a.mData, b.mData); }
+private:
+  // the copy runs before growing, so a span over the elements of the column stays valid
+  template<typename U>
+  void Append(std::span<const U> values)
+  {
+    mData.append_uninitialized(values.size(), [values](optional_type* first) { Copy(values, first); });
+  }
+
+  // copies `values` into the uninitialized storage at `dest`, nothing is left constructed when a copy throws
+  template<typename U>
+  static void Copy(std::span<const U> values, optional_type* dest)
+  {
+    if constexpr (bitwise_values) {
+      // the same check constructing each `optional_type` from a `T` does
+      if constexpr (std::is_same_v<U, T>)
+        for ([[maybe_unused]] const T& x : values)
+          ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(x),
+                                            "an appended value cannot be the null state value for `zxshady::tombstone_column`",
+                                            x);
+      if (!values.empty())
+        std::memcpy(static_cast<void*>(dest), values.data(), values.size_bytes());
+    }
+    else {
+      std::uninitialized_copy(values.begin(), values.end(), dest);
+    }
+  }
+
+  storage_type mData;
+};
+
+} // namespace zxshady
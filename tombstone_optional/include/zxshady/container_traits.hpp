@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+namespace container_traits_details {
+  // an object nobody else can point into, only its address is ever used
+  template<typename T>
+  union SentinelStorage {
+    char unused;
+    T    value;
+
+    constexpr SentinelStorage() noexcept : unused() {}
+    constexpr ~SentinelStorage() {}
+  };
+
+  template<typename T>
+  inline constinit SentinelStorage<T> sentinel_storage{};
+
+  template<typename T>
+  constexpr T* SentinelAddress() noexcept
+  {
+    return std::addressof(sentinel_storage<std::remove_cv_t<T>>.value);
+  }
+
+  // The first word of a libstdc++ or libc++ string/vector is either a data pointer or a capacity,
+  // all ones is impossible for both so it can be used without ever constructing the container.
+  template<typename T>
+  struct FirstWordTraits {
+    static_assert(sizeof(T) >= sizeof(std::uintptr_t));
+
+    static constexpr std::uintptr_t null_word = ~std::uintptr_t{0};
+
+    static void initialize_null_state(T& x) noexcept
+    {
+      std::memcpy(static_cast<void*>(std::addressof(x)), &null_word, sizeof(null_word));
+    }
+    static bool is_null(const T& x) noexcept
+    {
+      std::uintptr_t word;
+      std::memcpy(&word, static_cast<const void*>(std::addressof(x)), sizeof(word));
+      return word == null_word;
+    }
+  };
+} // namespace container_traits_details
+
+template<typename CharT, typename Traits>
+struct tombstone_traits<std::basic_string_view<CharT, Traits>> {
+private:
+  using type = std::basic_string_view<CharT, Traits>;
+public:
+  static constexpr void initialize_null_state(type& x) noexcept
+  {
+    std::construct_at(std::addressof(x), container_traits_details::SentinelAddress<CharT>(), 0);
+  }
+  static constexpr bool is_null(const type& x) noexcept
+  {
+    return x.data() == container_traits_details::SentinelAddress<CharT>();
+  }
+};
+
+template<typename T>
+struct tombstone_traits<std::span<T>> {
+  static constexpr void initialize_null_state(std::span<T>& x) noexcept
+  {
+    std::construct_at(std::addressof(x), container_traits_details::SentinelAddress<T>(), 0);
+  }
+  static constexpr bool is_null(const std::span<T>& x) noexcept
+  {
+    return x.data() == container_traits_details::SentinelAddress<T>();
+  }
+};
+
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)
+template<typename CharT, typename Traits>
+struct tombstone_traits<std::basic_string<CharT, Traits, std::allocator<CharT>>>
+: container_traits_details::FirstWordTraits<std::basic_string<CharT, Traits, std::allocator<CharT>>> {};
+
+template<typename T>
+struct tombstone_traits<std::vector<T, std::allocator<T>>>
+: container_traits_details::FirstWordTraits<std::vector<T, std::allocator<T>>> {};
+#endif
+
+} // namespace zxshady
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+namespace enum_traits_details {
+  // `E{U{}}` only compiles when `E` has a fixed underlying type, otherwise values outside
+  // of the enumerators range cannot be named in a constant expression
+  template<typename E>
+  concept FixedEnum = std::is_enum_v<E> && requires { E{std::underlying_type_t<E>{}}; } &&
+    (!std::same_as<std::underlying_type_t<E>, bool>);
+
+  template<auto V>
+  constexpr bool IsNamedEnumerator() noexcept
+  {
+#if defined(__clang__) || defined(__GNUC__)
+    constexpr std::string_view name  = __PRETTY_FUNCTION__; // "... [with auto V = E::Red]" or "[V = (E)255]"
+    constexpr std::size_t      start = name.rfind("= ") + 2;
+#elif defined(_MSC_VER)
+    constexpr std::string_view name  = __FUNCSIG__; // "... IsNamedEnumerator<E::Red>(void)" or "<(enum E)0xff>"
+    constexpr std::size_t      start = name.rfind('<') + 1;
+#else
+    static_assert(!sizeof(V), "unsupported compiler specialize `zxshady::tombstone_enum_null_value` instead");
+    constexpr std::string_view name  = "";
+    constexpr std::size_t      start = 0;
+#endif
+    // a value without an enumerator is printed as a cast, a named one can start with a namespace like
+    // `{anonymous}::` (GCC), `(anonymous namespace)::` (Clang) or `` `anonymous-namespace':: `` (MSVC)
+    constexpr std::string_view value = name.substr(start);
+    return !value.starts_with('(') || value.starts_with("(anonymous namespace)");
+  }
+
+  // tries the 64 largest values then the 64 smallest ones
+  template<typename E, std::size_t... I>
+  constexpr E FindUnusedValue(std::index_sequence<I...>)
+  {
+    using U            = std::underlying_type_t<E>;
+    constexpr U max    = std::numeric_limits<U>::max();
+    constexpr U min    = std::numeric_limits<U>::min();
+    bool        found  = false;
+    U           result = max;
+
+    ((found || IsNamedEnumerator<static_cast<E>(static_cast<U>(max - I))>() ||
+      (result = static_cast<U>(max - I), found = true)),
+     ...);
+    ((found || IsNamedEnumerator<static_cast<E>(static_cast<U>(min + I))>() ||
+      (result = static_cast<U>(min + I), found = true)),
+     ...);
+    if (!found)
+      throw "no unused value found specialize `zxshady::tombstone_enum_null_value`";
+    return static_cast<E>(result);
+  }
+} // namespace enum_traits_details
+
+// specialize this to choose the null value of an enum yourself
+template<typename E>
+  requires enum_traits_details::FixedEnum<E>
+inline constexpr E tombstone_enum_null_value = enum_traits_details::FindUnusedValue<E>(std::make_index_sequence<64>{});
+
+template<typename E>
+struct tombstone_enum_traits : tombstone_value_pattern<tombstone_enum_null_value<E>> {
+  static_assert(enum_traits_details::FixedEnum<E>, "E must be an enum with a fixed underlying type");
+  static_assert(!enum_traits_details::IsNamedEnumerator<tombstone_enum_null_value<E>>(),
+                "`tombstone_enum_null_value<E>` collides with an enumerator of E");
+};
+
+template<typename E>
+using optional_enum = tombstone_optional<E, tombstone_enum_traits<E>>;
+
+} // namespace zxshady
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional> // std::invoke
+#include <type_traits>
+#include <utility>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+template<typename E>
+class bad_tombstone_expected_access : public std::exception {
+public:
+  explicit bad_tombstone_expected_access(E e) noexcept : mError(e) {}
+
+  [[nodiscard]] const char* what() const noexcept override { return "bad access to zxshady::tombstone_expected"; }
+  [[nodiscard]] E           error() const noexcept { return mError; }
+private:
+  E mError;
+};
+
+template<typename E>
+class tombstone_unexpected {
+public:
+  constexpr explicit tombstone_unexpected(E e) noexcept : mError(e) {}
+
+  [[nodiscard]] constexpr E error() const noexcept { return mError; }
+private:
+  E mError;
+};
+
+struct tombstone_unexpect_t {
+  explicit tombstone_unexpect_t() = default;
+};
+inline constexpr tombstone_unexpect_t tombstone_unexpect{};
+
+// Stores either a `T` or an error code `E`, error `e` is kept in niche `e` of `Traits`
+// so `E` must be an enum or integer whose values are all below `tombstone_niche_count_v<Traits, T>`.
+template<typename T, typename E, typename Traits = tombstone_traits<T>>
+class tombstone_expected {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+  static_assert(std::is_enum_v<E> || std::is_integral_v<E>, "E must be an enum or an integer");
+  static_assert(concepts::tombstone_niche_traits_for<Traits, T>, "Traits must provide niches to store the errors in");
+  static_assert(concepts::tombstone_trivial_destroy_traits_for<Traits, T>,
+                "Traits must not define destroy_null_state, the niches are not objects");
+
+  using underlying_type =
+    typename std::conditional_t<std::is_enum_v<E>, std::underlying_type<E>, std::type_identity<E>>::type;
+public:
+  using value_type      = T;
+  using error_type      = E;
+  using traits_type     = Traits;
+  using unexpected_type = tombstone_unexpected<E>;
+
+  // the largest error code that fits
+  static constexpr std::size_t max_error = Traits::niche_count - 1;
+
+  constexpr tombstone_expected() noexcept(std::is_nothrow_default_constructible_v<T>)
+    requires std::is_default_constructible_v<T>
+  : mValue()
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(has_value(), "T() cannot be a niche of `zxshady::tombstone_expected`", mValue);
+  }
+
+  template<typename U = T>
+    requires std::constructible_from<T, U> &&
+    (!std::same_as<std::remove_cvref_t<U>, tombstone_expected>) && (!std::same_as<std::remove_cvref_t<U>, unexpected_type>)
+  explicit(!std::is_convertible_v<U, T>) constexpr tombstone_expected(U&& u) noexcept(
+    std::is_nothrow_constructible_v<T, U>)
+  : mValue(ZXFWD(u))
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(has_value(), "\"u\" cannot be a niche of `zxshady::tombstone_expected`", mValue);
+  }
+
+  constexpr tombstone_expected(const unexpected_type& e) noexcept { SetError(e.error()); }
+  constexpr explicit tombstone_expected(tombstone_unexpect_t, E e) noexcept { SetError(e); }
+
+  constexpr tombstone_expected& operator=(const unexpected_type& e) noexcept
+  {
+    SetError(e.error());
+    return *this;
+  }
+
+  template<typename U = T>
+    requires std::constructible_from<T, U> &&
+    (!std::same_as<std::remove_cvref_t<U>, tombstone_expected>) && (!std::same_as<std::remove_cvref_t<U>, unexpected_type>)
+  constexpr tombstone_expected& operator=(U&& u) noexcept(std::is_nothrow_constructible_v<T, U>)
+  {
+    std::construct_at(std::addressof(mValue), ZXFWD(u));
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(has_value(), "\"u\" cannot be a niche of `zxshady::tombstone_expected`", mValue);
+    return *this;
+  }
+
+  template<typename... Args>
+    requires std::constructible_from<T, Args...>
+  constexpr T& emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+  {
+    std::construct_at(std::addressof(mValue), ZXFWD(args)...);
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(has_value(), "Setting a niche in emplace", mValue);
+    return mValue;
+  }
+
+  [[nodiscard]] constexpr bool          has_value() const noexcept { return NicheIndex() == Traits::niche_count; }
+  [[nodiscard]] constexpr explicit operator bool() const noexcept { return has_value(); }
+
+  [[nodiscard]] constexpr E error() const noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!has_value(), "Calling error() on a tombstone_expected with a value!");
+    return static_cast<E>(static_cast<underlying_type>(NicheIndex()));
+  }
+
+  [[nodiscard]] constexpr T& operator*() & noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(has_value(), "Calling operator* on a tombstone_expected with an error!");
+    return mValue;
+  }
+  [[nodiscard]] constexpr const T& operator*() const& noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(has_value(), "Calling operator* on a tombstone_expected with an error!");
+    return mValue;
+  }
+
+  [[nodiscard]] constexpr T*       operator->() noexcept { return std::addressof(**this); }
+  [[nodiscard]] constexpr const T* operator->() const noexcept { return std::addressof(**this); }
+
+  [[nodiscard]] constexpr T& value() &
+  {
+    if (!has_value())
+      throw bad_tombstone_expected_access<E>(error());
+    return mValue;
+  }
+  [[nodiscard]] constexpr const T& value() const&
+  {
+    if (!has_value())
+      throw bad_tombstone_expected_access<E>(error());
+    return mValue;
+  }
+
+  template<typename U>
+  [[nodiscard]] constexpr T value_or(U&& default_value) const noexcept(std::is_nothrow_constructible_v<T, U>)
+  {
+    return has_value() ? mValue : static_cast<T>(ZXFWD(default_value));
+  }
+
+  template<typename U>
+  [[nodiscard]] constexpr E error_or(U&& default_error) const noexcept
+  {
+    return has_value() ? static_cast<E>(ZXFWD(default_error)) : error();
+  }
+
+  // `f` returns a `tombstone_expected<U, E, UTraits>`
+  template<typename F>
+  constexpr auto and_then(F&& f) const
+  {
+    using result_type = std::remove_cvref_t<std::invoke_result_t<F, const T&>>;
+    static_assert(std::is_same_v<typename result_type::error_type, E>,
+                  "f must return a tombstone_expected with the same error type");
+    if (has_value())
+      return std::invoke(ZXFWD(f), mValue);
+    return result_type(tombstone_unexpect, error());
+  }
+
+  // `f` returns a `tombstone_expected<T, E2, Traits2>`
+  template<typename F>
+  constexpr auto or_else(F&& f) const
+  {
+    using result_type = std::remove_cvref_t<std::invoke_result_t<F, E>>;
+    static_assert(std::is_same_v<typename result_type::value_type, T>,
+                  "f must return a tombstone_expected with the same value type");
+    if (has_value())
+      return result_type(mValue);
+    return std::invoke(ZXFWD(f), error());
+  }
+
+  // `f` returns a `U`, the result uses `UTraits` which default to `tombstone_traits<U>`
+  template<typename UTraits = void, typename F>
+  constexpr auto transform(F&& f) const
+  {
+    using U           = std::remove_cv_t<std::invoke_result_t<F, const T&>>;
+    using result_type =
+      tombstone_expected<U, E, std::conditional_t<std::is_void_v<UTraits>, tombstone_traits<U>, UTraits>>;
+    if (has_value())
+      return result_type(std::invoke(ZXFWD(f), mValue));
+    return result_type(tombstone_unexpect, error());
+  }
+
+  // `f` returns an error code `G`, the niches of `Traits` are reused
+  template<typename F>
+  constexpr auto transform_error(F&& f) const
+  {
+    using G           = std::remove_cv_t<std::invoke_result_t<F, E>>;
+    using result_type = tombstone_expected<T, G, Traits>;
+    if (has_value())
+      return result_type(mValue);
+    return result_type(tombstone_unexpect, std::invoke(ZXFWD(f), error()));
+  }
+
+  [[nodiscard]] friend constexpr bool operator==(const tombstone_expected& a, const tombstone_expected& b) noexcept
+    requires std::equality_comparable<T>
+  {
+    const std::size_t index = a.NicheIndex();
+    return index == b.NicheIndex() && (index != Traits::niche_count || a.mValue == b.mValue);
+  }
+
+  [[nodiscard]] friend constexpr bool operator==(const tombstone_expected& a, const unexpected_type& e) noexcept
+  {
+    return !a.has_value() && a.error() == e.error();
+  }
+private:
+  [[nodiscard]] constexpr std::size_t NicheIndex() const noexcept { return Traits::niche_index(mValue); }
+
+  constexpr void SetError(E e) noexcept
+  {
+    const auto index = static_cast<std::size_t>(static_cast<underlying_type>(e));
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(index <= max_error, "the error code does not fit in the niches of T", e);
+    Traits::initialize_niche(mValue, index);
+  }
+
+  union {
+    T mValue;
+  };
+};
+
+} // namespace zxshady
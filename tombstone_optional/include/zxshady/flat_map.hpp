@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <zxshady/hash.hpp>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+// An open addressing hash map with linear probing whose slots are exactly `sizeof(std::pair<K, V>)`.
+// Niche 0 of `KeyTraits` marks an empty slot and niche 1 an erased one, so keys equal to either are not allowed.
+// Elements are `std::pair<K, V>`, changing the key of an element in place is undefined.
+template<typename K,
+         typename V,
+         typename KeyTraits = tombstone_traits<K>,
+         typename Hash      = tombstone_hash<K, KeyTraits>,
+         typename KeyEqual  = tombstone_equal<K, KeyTraits>>
+class tombstone_flat_map {
+public:
+  using key_type    = K;
+  using mapped_type = V;
+  using value_type  = std::pair<K, V>;
+  using size_type   = std::size_t;
+  using hasher      = Hash;
+  using key_equal   = KeyEqual;
+  using reference   = value_type&;
+  using pointer     = value_type*;
+private:
+  static_assert(concepts::tombstone_niche_traits_for<KeyTraits, K> && tombstone_niche_count_v<KeyTraits, K> >= 2,
+                "KeyTraits must provide an empty and an erased niche");
+  static_assert(concepts::tombstone_trivial_destroy_traits_for<KeyTraits, K>,
+                "KeyTraits must not define destroy_null_state, the niches are not objects");
+  static_assert(std::is_nothrow_move_constructible_v<value_type>, "rehashing moves the elements");
+
+  // The inner optional is null in an empty slot, the outer one uses the next niche and is null in an erased slot.
+  // Destroying a slot therefore only destroys the pair when there is one.
+  using entry_type = tombstone_optional<value_type, tombstone_member_traits<&value_type::first, KeyTraits>>;
+  using slot_type  = tombstone_optional<entry_type>;
+
+  enum class SlotState { Empty, Erased, Full };
+
+  static SlotState State(const slot_type& slot) noexcept
+  {
+    using tombstone_optional_details::Access;
+    switch (KeyTraits::niche_index(Access::Value(Access::Value(slot)).first)) {
+    case 0: return SlotState::Empty;
+    case 1: return SlotState::Erased;
+    default: return SlotState::Full;
+    }
+  }
+
+  template<typename Slot>
+  static auto& Element(Slot& slot) noexcept
+  {
+    return **slot;
+  }
+
+  template<bool Const>
+  class Iterator {
+    using slot_pointer = std::conditional_t<Const, const slot_type*, slot_type*>;
+  public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = tombstone_flat_map::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::conditional_t<Const, const value_type&, value_type&>;
+    using pointer           = std::conditional_t<Const, const value_type*, value_type*>;
+
+    Iterator() = default;
+    Iterator(slot_pointer current, slot_pointer last) noexcept : mCurrent(current), mLast(last) {}
+
+    // a mutable iterator converts to a const one
+    operator Iterator<true>() const noexcept
+      requires(!Const)
+    {
+      return {mCurrent, mLast};
+    }
+
+    [[nodiscard]] reference operator*() const noexcept { return Element(*mCurrent); }
+    [[nodiscard]] pointer   operator->() const noexcept { return std::addressof(Element(*mCurrent)); }
+
+    Iterator& operator++() noexcept
+    {
+      do
+        ++mCurrent;
+      while (mCurrent != mLast && State(*mCurrent) != SlotState::Full);
+      return *this;
+    }
+    Iterator operator++(int) noexcept
+    {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    [[nodiscard]] friend bool operator==(const Iterator& a, const Iterator& b) noexcept
+    {
+      return a.mCurrent == b.mCurrent;
+    }
+  private:
+    friend class tombstone_flat_map;
+
+    slot_pointer mCurrent = nullptr;
+    slot_pointer mLast    = nullptr;
+  };
+
+  template<typename Q>
+  static constexpr bool transparent_key = requires(const Hash& hash, const KeyEqual& equal, const K& k, const Q& q) {
+    typename Hash::is_transparent;
+    typename KeyEqual::is_transparent;
+    hash(q);
+    equal(k, q);
+  };
+public:
+  using iterator       = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // the map grows when more than 7/8 of the slots are full or erased
+  static constexpr size_type max_load_numerator   = 7;
+  static constexpr size_type max_load_denominator = 8;
+
+  tombstone_flat_map() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                                std::is_nothrow_default_constructible_v<KeyEqual>) = default;
+
+  explicit tombstone_flat_map(size_type bucket_count, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+  : mHash(hash)
+  , mEqual(equal)
+  {
+    reserve(bucket_count);
+  }
+
+  tombstone_flat_map(const tombstone_flat_map& that)
+    requires std::is_copy_constructible_v<value_type>
+  : mHash(that.mHash)
+  , mEqual(that.mEqual)
+  {
+    reserve(that.size());
+    for (const value_type& x : that)
+      try_emplace(x.first, x.second);
+  }
+
+  tombstone_flat_map(tombstone_flat_map&& that) noexcept
+  : mHash(std::move(that.mHash))
+  , mEqual(std::move(that.mEqual))
+  , mSlots(std::exchange(that.mSlots, nullptr))
+  , mCapacity(std::exchange(that.mCapacity, 0))
+  , mSize(std::exchange(that.mSize, 0))
+  , mErased(std::exchange(that.mErased, 0))
+  {
+  }
+
+  tombstone_flat_map& operator=(tombstone_flat_map that) noexcept
+  {
+    swap(*this, that);
+    return *this;
+  }
+
+  ~tombstone_flat_map() { Free(mSlots, mCapacity); }
+
+  [[nodiscard]] iterator       begin() noexcept { return First<iterator>(mSlots, mCapacity); }
+  [[nodiscard]] const_iterator begin() const noexcept { return First<const_iterator>(mSlots, mCapacity); }
+  [[nodiscard]] iterator       end() noexcept { return {mSlots + mCapacity, mSlots + mCapacity}; }
+  [[nodiscard]] const_iterator end() const noexcept { return {mSlots + mCapacity, mSlots + mCapacity}; }
+
+  [[nodiscard]] size_type size() const noexcept { return mSize; }
+  [[nodiscard]] bool      empty() const noexcept { return mSize == 0; }
+  [[nodiscard]] size_type bucket_count() const noexcept { return mCapacity; }
+
+  void reserve(size_type count)
+  {
+    size_type capacity = 16;
+    while (capacity * max_load_numerator < count * max_load_denominator)
+      capacity *= 2;
+    if (capacity > mCapacity)
+      Rehash(capacity);
+  }
+
+  template<typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT((KeyTraits::niche_index(key) == tombstone_niche_count_v<KeyTraits, K>),
+                                      "the key is a niche of KeyTraits",
+                                      key);
+    if (slot_type* const slot = Find(key, Home(key)))
+      return {MakeIterator(slot), false};
+
+    if ((mSize + mErased + 1) * max_load_denominator > mCapacity * max_load_numerator) {
+      // construct first so a key or arguments referring to an element stay valid while growing
+      const size_type  new_capacity = mSize + 1 > mCapacity / 2 ? std::max<size_type>(16, mCapacity * 2) : mCapacity;
+      slot_type* const slots        = Allocate(new_capacity);
+      slot_type* const target       = slots + Home(key, new_capacity);
+      try {
+        Construct(target, key, ZXFWD(args)...);
+      }
+      catch (...) {
+        std::construct_at(target, std::in_place);
+        Free(slots, new_capacity);
+        throw;
+      }
+      Adopt(slots, new_capacity);
+      ++mSize;
+      return {MakeIterator(target), true};
+    }
+
+    // the key is not in the map so the first slot without an element is free
+    const size_type mask  = mCapacity - 1;
+    size_type       index = Home(key);
+    while (State(mSlots[index]) == SlotState::Full)
+      index = (index + 1) & mask;
+    slot_type* const target = &mSlots[index];
+    const bool       reuse  = State(*target) == SlotState::Erased;
+    try {
+      Construct(target, key, ZXFWD(args)...);
+    }
+    catch (...) {
+      // a half constructed pair may have written the key, the slot goes back to what it was
+      if (reuse)
+        std::construct_at(target);
+      else
+        std::construct_at(target, std::in_place);
+      throw;
+    }
+    if (reuse)
+      --mErased;
+    ++mSize;
+    return {MakeIterator(target), true};
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+  std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+  template<typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& mapped)
+  {
+    auto result = try_emplace(key, ZXFWD(mapped));
+    if (!result.second)
+      result.first->second = ZXFWD(mapped);
+    return result;
+  }
+
+  V& operator[](const K& key)
+    requires std::is_default_constructible_v<V>
+  {
+    return try_emplace(key).first->second;
+  }
+
+  [[nodiscard]] iterator find(const K& key) { return FindIterator(key); }
+  [[nodiscard]] const_iterator find(const K& key) const
+  {
+    return const_cast<tombstone_flat_map&>(*this).FindIterator(key);
+  }
+  [[nodiscard]] bool contains(const K& key) const { return find(key) != end(); }
+
+  // lookups by any key the transparent `Hash` and `KeyEqual` accept
+  template<typename Q>
+    requires transparent_key<Q>
+  [[nodiscard]] iterator find(const Q& key)
+  {
+    return FindIterator(key);
+  }
+  template<typename Q>
+    requires transparent_key<Q>
+  [[nodiscard]] const_iterator find(const Q& key) const
+  {
+    return const_cast<tombstone_flat_map&>(*this).FindIterator(key);
+  }
+  template<typename Q>
+    requires transparent_key<Q>
+  [[nodiscard]] bool contains(const Q& key) const
+  {
+    return find(key) != end();
+  }
+
+  // Looks up every key of `keys` and writes a pointer to its element, or nullptr, to `out`.
+  // The home slots of the next keys are prefetched while the current ones are probed, which hides
+  // most of the cache misses of a table much larger than the caches.
+  template<typename Q = K>
+    requires std::is_same_v<Q, K> || transparent_key<Q>
+  void find_batch(std::span<const Q> keys, std::span<pointer> out)
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(out.size() >= keys.size(), "find_batch output is too small");
+    constexpr size_type window = 16;
+
+    size_type homes[window];
+    for (size_type first = 0; first < keys.size(); first += window) {
+      const size_type count = std::min(window, keys.size() - first);
+      for (size_type i = 0; i < count; ++i) {
+        homes[i] = Home(keys[first + i]);
+#if defined(__GNUC__) || defined(__clang__)
+        if (mCapacity != 0)
+          __builtin_prefetch(mSlots + homes[i]);
+#endif
+      }
+      for (size_type i = 0; i < count; ++i) {
+        slot_type* const slot = Find(keys[first + i], homes[i]);
+        out[first + i]        = slot ? std::addressof(Element(*slot)) : nullptr;
+      }
+    }
+  }
+
+  size_type erase(const K& key)
+  {
+    slot_type* const slot = Find(key, Home(key));
+    if (!slot)
+      return 0;
+    Erase(*slot);
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) noexcept
+  {
+    slot_type* const slot = const_cast<slot_type*>(pos.mCurrent);
+    Erase(*slot);
+    iterator next{slot, mSlots + mCapacity};
+    return ++next;
+  }
+
+  void clear() noexcept
+  {
+    for (size_type i = 0; i < mCapacity; ++i) {
+      std::destroy_at(mSlots + i);
+      std::construct_at(mSlots + i, std::in_place);
+    }
+    mSize   = 0;
+    mErased = 0;
+  }
+
+  friend void swap(tombstone_flat_map& a, tombstone_flat_map& b) noexcept
+  {
+    using std::swap;
+    swap(a.mHash, b.mHash);
+    swap(a.mEqual, b.mEqual);
+    swap(a.mSlots, b.mSlots);
+    swap(a.mCapacity, b.mCapacity);
+    swap(a.mSize, b.mSize);
+    swap(a.mErased, b.mErased);
+  }
+private:
+  template<typename Q>
+  iterator FindIterator(const Q& key)
+  {
+    slot_type* const slot = Find(key, Home(key));
+    return slot ? MakeIterator(slot) : end();
+  }
+
+  template<typename Q>
+  [[nodiscard]] size_type Home(const Q& key) const
+  {
+    return Home(key, mCapacity);
+  }
+
+  template<typename Q>
+  [[nodiscard]] size_type Home(const Q& key, size_type capacity) const
+  {
+    // mixed again so identity hashes of integers still spread over the table
+    return static_cast<size_type>(hash_details::Mix(mHash(key))) & (capacity - 1);
+  }
+
+  template<typename Q>
+  [[nodiscard]] slot_type* Find(const Q& key, size_type index) const
+  {
+    if (mCapacity == 0)
+      return nullptr;
+    const size_type mask = mCapacity - 1;
+    for (;; index = (index + 1) & mask) {
+      slot_type& slot = mSlots[index];
+      switch (State(slot)) {
+      case SlotState::Empty: return nullptr;
+      case SlotState::Erased: break;
+      case SlotState::Full:
+        if (mEqual(Element(slot).first, key))
+          return &slot;
+        break;
+      }
+    }
+  }
+
+  void Erase(slot_type& slot) noexcept
+  {
+    // the outer optional is reset to its null state, that is the erased niche
+    slot.reset();
+    --mSize;
+    ++mErased;
+  }
+
+  template<typename It, typename Slot>
+  static It First(Slot* slots, size_type capacity) noexcept
+  {
+    It it{slots, slots + capacity};
+    if (capacity != 0 && State(*slots) != SlotState::Full)
+      ++it;
+    return it;
+  }
+
+  iterator MakeIterator(slot_type* slot) noexcept { return {slot, mSlots + mCapacity}; }
+
+  template<typename... Args>
+  static void Construct(slot_type* slot, const K& key, Args&&... args)
+  {
+    std::construct_at(slot,
+                      std::in_place,
+                      std::in_place,
+                      std::piecewise_construct,
+                      std::forward_as_tuple(key),
+                      std::forward_as_tuple(ZXFWD(args)...));
+  }
+
+  void Rehash(size_type new_capacity) { Adopt(Allocate(new_capacity), new_capacity); }
+
+  // empty slots, `std::allocator` respects the alignment of `slot_type`
+  static slot_type* Allocate(size_type capacity)
+  {
+    slot_type* const slots = std::allocator<slot_type>().allocate(capacity);
+    for (size_type i = 0; i < capacity; ++i)
+      std::construct_at(slots + i, std::in_place);
+    return slots;
+  }
+
+  // moves the elements into `slots`, which may already hold some, and frees the old slots
+  void Adopt(slot_type* slots, size_type new_capacity) noexcept
+  {
+    slot_type* const old_slots    = std::exchange(mSlots, slots);
+    const size_type  old_capacity = std::exchange(mCapacity, new_capacity);
+    const size_type  mask         = new_capacity - 1;
+    for (size_type i = 0; i < old_capacity; ++i) {
+      if (State(old_slots[i]) != SlotState::Full)
+        continue;
+      value_type& element = Element(old_slots[i]);
+      size_type   index   = Home(element.first);
+      while (State(slots[index]) != SlotState::Empty)
+        index = (index + 1) & mask;
+      std::construct_at(slots + index, std::in_place, std::in_place, std::move(element));
+    }
+    mErased = 0;
+    Free(old_slots, old_capacity);
+  }
+
+  static void Free(slot_type* slots, size_type capacity) noexcept
+  {
+    if (!slots)
+      return;
+    std::destroy(slots, slots + capacity);
+    std::allocator<slot_type>().deallocate(slots, capacity);
+  }
+
+  [[no_unique_address]] Hash     mHash{};
+  [[no_unique_address]] KeyEqual mEqual{};
+
+  slot_type* mSlots    = nullptr;
+  size_type  mCapacity = 0;
+  size_type  mSize     = 0;
+  size_type  mErased   = 0;
+};
+
+} // namespace zxshady
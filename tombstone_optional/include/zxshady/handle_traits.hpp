@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+// POSIX file descriptors are never negative and -1 is what every api returns on failure
+using tombstone_fd_traits = tombstone_value_pattern<-1>;
+
+using optional_fd = tombstone_optional<int, tombstone_fd_traits>;
+
+// The null states below are default constructed handles, destroying those is a no-op so the traits
+// do not define `destroy_null_state` and a null handle is never destroyed. The exception is a
+// `std::unique_ptr` whose deleter has a destructor to run.
+
+template<typename T, typename Deleter>
+  requires std::is_nothrow_default_constructible_v<Deleter>
+struct tombstone_traits<std::unique_ptr<T, Deleter>> {
+private:
+  using type = std::unique_ptr<T, Deleter>;
+public:
+  static constexpr bool null_is_zero_bits = std::is_empty_v<Deleter> &&
+                                          std::is_pointer_v<typename type::pointer> &&
+                                          sizeof(type) == sizeof(typename type::pointer);
+
+  static constexpr void initialize_null_state(type& x) noexcept { std::construct_at(std::addressof(x)); }
+  static bool           is_null(const type& x) noexcept { return x.get() == nullptr; }
+
+  // the pointer is null so this only destroys the deleter
+  static constexpr void destroy_null_state(type& x) noexcept
+    requires(!std::is_trivially_destructible_v<Deleter>)
+  {
+    std::destroy_at(std::addressof(x));
+  }
+};
+
+// a shared_ptr that stores nullptr but owns a control block is still a value
+template<typename T>
+struct tombstone_traits<std::shared_ptr<T>> {
+  static constexpr void initialize_null_state(std::shared_ptr<T>& x) noexcept { std::construct_at(std::addressof(x)); }
+  static bool           is_null(const std::shared_ptr<T>& x) noexcept { return !x && x.use_count() == 0; }
+};
+
+template<typename R, typename... Args>
+struct tombstone_traits<std::function<R(Args...)>> {
+private:
+  using type = std::function<R(Args...)>;
+public:
+  static void initialize_null_state(type& x) noexcept { std::construct_at(std::addressof(x)); }
+  static bool is_null(const type& x) noexcept { return !x; }
+};
+
+} // namespace zxshady
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <zxshady/optional.hpp>
+#include <zxshady/presence.hpp>
+
+namespace zxshady {
+
+namespace hash_details {
+  // a multiply-xorshift finalizer, every input bit affects every output bit and 0 does not hash to 0
+  constexpr std::uint64_t Mix(std::uint64_t x) noexcept
+  {
+    x += 0x2545'f491'4f6c'dd1dull;
+    x ^= x >> 32;
+    x *= 0xd6e8'feb8'6659'fd93ull;
+    x ^= x >> 32;
+    x *= 0xd6e8'feb8'6659'fd93ull;
+    x ^= x >> 32;
+    return x;
+  }
+
+  template<typename T>
+  concept Mixable = std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+  template<typename T>
+  std::uint64_t Bits(const T& x) noexcept
+  {
+    typename tombstone_optional_details::UnsignedOfSize<sizeof(T)>::type bits;
+    std::memcpy(&bits, std::addressof(x), sizeof(T));
+    return bits;
+  }
+
+  template<std::size_t Size>
+  [[gnu::always_inline]] inline std::size_t HashBits(const unsigned char* p, std::uint64_t pattern, std::size_t null_hash) noexcept
+  {
+    using bits_type = typename tombstone_optional_details::UnsignedOfSize<Size>::type;
+    bits_type bits;
+    std::memcpy(&bits, p, Size);
+    const auto mixed = static_cast<std::size_t>(Mix(bits));
+    return bits != static_cast<bits_type>(pattern) ? mixed : null_hash;
+  }
+
+  // No branches so the loop is vectorized, it is compiled once per instruction set below.
+  // GCC at -O2 only vectorizes loops that need no scalar epilogue and no runtime alias check,
+  // so the blocks have a constant trip count and the pointers are restrict.
+  template<std::size_t Size>
+  [[gnu::always_inline]] inline void HashBitsLoop(const unsigned char* __restrict p,
+                                                  std::size_t                     count,
+                                                  std::uint64_t                   pattern,
+                                                  std::size_t                     null_hash,
+                                                  std::size_t* __restrict out) noexcept
+  {
+    constexpr std::size_t block = 16;
+    std::size_t           i     = 0;
+    for (; count - i >= block; i += block) {
+      const unsigned char* const block_p   = p + i * Size;
+      std::size_t* const         block_out = out + i;
+      for (std::size_t j = 0; j < block; ++j)
+        block_out[j] = HashBits<Size>(block_p + j * Size, pattern, null_hash);
+    }
+    for (; i < count; ++i)
+      out[i] = HashBits<Size>(p + i * Size, pattern, null_hash);
+  }
+
+  using HashKernel = void (*)(const unsigned char*, std::size_t, std::uint64_t, std::size_t, std::size_t*) noexcept;
+
+  template<std::size_t Size>
+  void HashBitsDefault(
+    const unsigned char* p, std::size_t count, std::uint64_t pattern, std::size_t null_hash, std::size_t* out) noexcept
+  {
+    HashBitsLoop<Size>(p, count, pattern, null_hash, out);
+  }
+
+#if ZXSHADY_OPTIONAL_PRESENCE_X86
+  template<std::size_t Size>
+  [[gnu::target("avx2")]] void HashBitsAvx2(
+    const unsigned char* p, std::size_t count, std::uint64_t pattern, std::size_t null_hash, std::size_t* out) noexcept
+  {
+    HashBitsLoop<Size>(p, count, pattern, null_hash, out);
+  }
+
+  // AVX-512DQ has the 64 bit multiply the mixer needs
+  template<std::size_t Size>
+  [[gnu::target("avx512f,avx512dq,avx512bw,avx512vl")]] void HashBitsAvx512(
+    const unsigned char* p, std::size_t count, std::uint64_t pattern, std::size_t null_hash, std::size_t* out) noexcept
+  {
+    HashBitsLoop<Size>(p, count, pattern, null_hash, out);
+  }
+
+  template<std::size_t Size>
+  HashKernel SelectHashKernel() noexcept
+  {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl"))
+      return &HashBitsAvx512<Size>;
+    if (__builtin_cpu_supports("avx2"))
+      return &HashBitsAvx2<Size>;
+    return &HashBitsDefault<Size>;
+  }
+#else
+  template<std::size_t Size>
+  HashKernel SelectHashKernel() noexcept
+  {
+    return &HashBitsDefault<Size>;
+  }
+#endif
+} // namespace hash_details
+
+// Hashes a `tombstone_optional` of a trivially copyable `T` by mixing its bits, nulls hash to `tombstone_null_hash_v`.
+// Unlike `std::hash<int>` on libstdc++ this is not the identity, use it as the hasher of tables filled with `hash_batch`.
+template<typename T, typename Traits = tombstone_traits<T>>
+  requires hash_details::Mixable<T>
+struct tombstone_mix_hash {
+  [[nodiscard]] std::size_t operator()(const tombstone_optional<T, Traits>& o) const noexcept
+  {
+    return o.has_value() ? static_cast<std::size_t>(hash_details::Mix(hash_details::Bits(*o))) :
+                           tombstone_null_hash_v<Traits>;
+  }
+};
+
+// `out[i] = tombstone_mix_hash<T, Traits>{}(in[i])`, `out` must be at least as large as `in` and not overlap it.
+// When the null state is a constant bit pattern the loop has no branches and is vectorized
+// with AVX2 or AVX-512 picked at runtime on x86-64.
+template<typename T, typename Traits>
+  requires hash_details::Mixable<T>
+void hash_batch(std::span<const tombstone_optional<T, Traits>> in, std::span<std::size_t> out) noexcept
+{
+  ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(out.size() >= in.size(), "hash_batch output is too small");
+  if constexpr (presence_details::HasNullPattern<Traits, T> && sizeof(tombstone_optional<T, Traits>) == sizeof(T)) {
+    static const hash_details::HashKernel kernel = hash_details::SelectHashKernel<sizeof(T)>();
+    constexpr auto                        pattern = *presence_details::NullPattern<Traits, T>();
+    kernel(reinterpret_cast<const unsigned char*>(in.data()),
+           in.size(),
+           static_cast<std::uint64_t>(pattern),
+           tombstone_null_hash_v<Traits>,
+           out.data());
+  }
+  else {
+    const tombstone_mix_hash<T, Traits> hash;
+    for (std::size_t i = 0; i < in.size(); ++i)
+      out[i] = hash(in[i]);
+  }
+}
+
+template<typename T, typename Traits>
+  requires hash_details::Mixable<T>
+void hash_batch(std::span<tombstone_optional<T, Traits>> in, std::span<std::size_t> out) noexcept
+{
+  hash_batch(std::span<const tombstone_optional<T, Traits>>(in), out);
+}
+
+// Whether a `K` can be looked up in a table of `tombstone_optional<T>` without making a `T`.
+// It requires `k == t` and hashing `k` gives `std::hash<T>{}(T(k))`.
+// Specialize it for your own types when `std::hash<K>` agrees with `std::hash<T>`.
+template<typename T, typename K>
+struct tombstone_hash_compatible : std::is_same<T, K> {};
+
+// the standard guarantees a string and a string_view of the same characters hash the same
+template<typename CharT, typename CharTraits, typename Allocator, typename K>
+  requires std::is_convertible_v<const K&, std::basic_string_view<CharT, CharTraits>>
+struct tombstone_hash_compatible<std::basic_string<CharT, CharTraits, Allocator>, K> : std::true_type {};
+
+template<typename T, typename K>
+inline constexpr bool tombstone_hash_compatible_v = tombstone_hash_compatible<T, std::remove_cvref_t<K>>::value;
+
+namespace hash_details {
+  template<typename T>
+  struct HashAs {
+    using type = T;
+  };
+
+  template<typename CharT, typename CharTraits, typename Allocator>
+  struct HashAs<std::basic_string<CharT, CharTraits, Allocator>> {
+    using type = std::basic_string_view<CharT, CharTraits>;
+  };
+
+  template<typename U, typename T>
+  concept OptionalOfCompatible =
+    tombstone_optional_details::TombstoneOptional<U> && tombstone_hash_compatible_v<T, typename U::value_type>;
+
+  // what a transparent functor for a `tombstone_optional<T>` accepts
+  template<typename K, typename T>
+  concept Key = std::is_same_v<std::remove_cvref_t<K>, std::nullopt_t> ||
+    OptionalOfCompatible<std::remove_cvref_t<K>, T> ||
+    (tombstone_hash_compatible_v<T, K> && !tombstone_optional_details::TombstoneOptional<std::remove_cvref_t<K>>);
+} // namespace hash_details
+
+// A transparent hasher for `tombstone_optional<T, Traits>` keys, it also accepts `std::nullopt`, values of a type `K`
+// with `tombstone_hash_compatible_v<T, K>` and other optionals of such a type. It gives the same hash as
+// `std::hash<tombstone_optional<T, Traits>>` for the equal key.
+template<typename T, typename Traits = tombstone_traits<T>>
+struct tombstone_hash {
+  using is_transparent = void;
+
+  template<hash_details::Key<T> K>
+  [[nodiscard]] std::size_t operator()(const K& key) const noexcept
+  {
+    if constexpr (std::is_same_v<K, std::nullopt_t>)
+      return tombstone_null_hash_v<Traits>;
+    else if constexpr (tombstone_optional_details::TombstoneOptional<K>)
+      return key.has_value() ? (*this)(*key) : tombstone_null_hash_v<Traits>;
+    else
+      return std::hash<typename hash_details::HashAs<T>::type>{}(key);
+  }
+};
+
+// A transparent equality for `tombstone_optional<T, Traits>` keys that accepts the same keys as `tombstone_hash`.
+// Unlike `operator==` two nulls are equal so a null key can be found in a table.
+template<typename T, typename Traits = tombstone_traits<T>>
+struct tombstone_equal {
+  using is_transparent = void;
+
+  template<hash_details::Key<T> A, hash_details::Key<T> B>
+  [[nodiscard]] bool operator()(const A& a, const B& b) const
+  {
+    const bool a_present = Present(a);
+    const bool b_present = Present(b);
+    if (!a_present || !b_present)
+      return a_present == b_present;
+    if constexpr (!std::is_same_v<A, std::nullopt_t> && !std::is_same_v<B, std::nullopt_t>)
+      return Value(a) == Value(b);
+    else
+      return false;
+  }
+private:
+  template<typename K>
+  static bool Present(const K& key) noexcept
+  {
+    if constexpr (std::is_same_v<K, std::nullopt_t>)
+      return false;
+    else if constexpr (tombstone_optional_details::TombstoneOptional<K>)
+      return key.has_value();
+    else
+      return true;
+  }
+
+  template<typename K>
+  static const auto& Value(const K& key) noexcept
+  {
+    if constexpr (tombstone_optional_details::TombstoneOptional<K>)
+      return *key;
+    else
+      return key;
+  }
+};
+
+} // namespace zxshady
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+// A lossy cache of `N` results, a key maps to one set of `Ways` entries and a miss evicts the least recently used one.
+// An empty entry is the null state of `Traits` on its key so entries are exactly `sizeof(std::pair<Key, Value>)`,
+// the key of the null state cannot be cached.
+template<typename Key, typename Value, std::size_t N, typename Traits = tombstone_traits<Key>, std::size_t Ways = 1>
+class tombstone_memo_cache {
+  static_assert(Ways == 1 || Ways == 2, "tombstone_memo_cache is direct mapped or 2-way set associative");
+  static_assert(std::has_single_bit(N) && N >= Ways, "N must be a power of two");
+  static_assert(concepts::tombstone_traits_for<Traits, Key>, "Traits must be a tombstone_traits class for Key");
+
+  using entry_type =
+    tombstone_optional<std::pair<Key, Value>, tombstone_member_traits<&std::pair<Key, Value>::first, Traits>>;
+
+  static constexpr std::size_t set_count = N / Ways;
+public:
+  using key_type    = Key;
+  using mapped_type = Value;
+  using traits_type = Traits;
+  using hasher      = std::hash<Key>;
+
+  static constexpr std::size_t ways = Ways;
+
+  [[nodiscard]] static constexpr std::size_t capacity() noexcept { return N; }
+
+  // The cached value for `key`, or `fn(key)` which is cached first.
+  // The reference is valid until the next call that changes the cache.
+  template<typename F>
+    requires std::is_invocable_r_v<Value, F&, const Key&>
+  const Value& get_or_compute(const Key& key, F&& fn)
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(key), "the null state of Traits cannot be cached", key);
+    entry_type* const set = Set(key);
+    if (Matches(set[0], key)) {
+      ++mHits;
+      return set[0]->second;
+    }
+    if constexpr (Ways == 2) {
+      if (Matches(set[1], key)) {
+        ++mHits;
+        // the most recently used entry is kept in the first way
+        std::swap(set[0], set[1]);
+        return set[0]->second;
+      }
+    }
+
+    ++mMisses;
+    Value value = std::invoke(fn, key);
+    if constexpr (Ways == 2)
+      set[1] = std::move(set[0]);
+    set[0].emplace(key, std::move(value));
+    return set[0]->second;
+  }
+
+  // the cached value for `key` or nullptr, the counters and the order of the set are unchanged
+  [[nodiscard]] const Value* find(const Key& key) const noexcept
+  {
+    const entry_type* const set = Set(key);
+    for (std::size_t way = 0; way < Ways; ++way)
+      if (Matches(set[way], key))
+        return &set[way]->second;
+    return nullptr;
+  }
+
+  // drops `key` from the cache and returns whether it was cached
+  bool invalidate(const Key& key) noexcept
+  {
+    entry_type* const set = Set(key);
+    for (std::size_t way = 0; way < Ways; ++way) {
+      if (Matches(set[way], key)) {
+        set[way].reset();
+        if constexpr (Ways == 2) {
+          // a miss moves the first way over the second one, so the empty way must be the second
+          if (way == 0 && set[1].has_value()) {
+            set[0] = std::move(set[1]);
+            set[1].reset();
+          }
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void clear() noexcept
+  {
+    for (entry_type& entry : mEntries)
+      entry.reset();
+  }
+
+  [[nodiscard]] std::size_t hits() const noexcept { return mHits; }
+  [[nodiscard]] std::size_t misses() const noexcept { return mMisses; }
+  void                      reset_counters() noexcept { mHits = mMisses = 0; }
+private:
+  static bool Matches(const entry_type& entry, const Key& key) noexcept
+  {
+    return entry.has_value() && entry->first == key;
+  }
+
+  // Fibonacci hashing, the top bits of the product depend on every bit of the hash
+  // so ids that only differ in their high bits still spread over the sets
+  static std::size_t SetIndex(const Key& key) noexcept
+  {
+    if constexpr (set_count == 1) {
+      return 0;
+    }
+    else {
+      const auto product = static_cast<std::uint64_t>(hasher{}(key)) * 0x9e37'79b9'7f4a'7c15ull;
+      return static_cast<std::size_t>(product >> (64 - std::countr_zero(set_count)));
+    }
+  }
+
+  entry_type*       Set(const Key& key) noexcept { return mEntries.data() + SetIndex(key) * Ways; }
+  const entry_type* Set(const Key& key) const noexcept { return mEntries.data() + SetIndex(key) * Ways; }
+
+  std::array<entry_type, N> mEntries{};
+  std::size_t               mHits   = 0;
+  std::size_t               mMisses = 0;
+};
+
+} // namespace zxshady
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <zxshady/atomic.hpp>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+namespace mpmc_ring_details {
+  inline constexpr std::size_t cache_line = 64;
+
+  template<typename Atomic, bool Padded>
+  struct Slot {
+    Atomic value;
+  };
+
+  // one slot per cache line so producers and consumers of neighbouring slots do not share a line
+  template<typename Atomic>
+  struct alignas(cache_line) Slot<Atomic, true> {
+    Atomic value;
+  };
+
+  template<typename Spin>
+  void SpinUntil(Spin&& done) noexcept
+  {
+    for (int i = 0; !done(); ++i)
+      if (i >= 64)
+        std::this_thread::yield();
+  }
+} // namespace mpmc_ring_details
+
+// A bounded multi producer multi consumer queue whose slots are `atomic_tombstone_optional<T, Traits>`, the null
+// state is an empty slot so there is no sequence number per slot. Producers and consumers claim tickets by CAS on a
+// tail and a head counter, then a producer CASes its slot from null to the value and a consumer exchanges it back
+// to null, waiting for the other side when it got there first.
+//
+// Ordering is relaxed compared to a sequence numbered queue: a slot does not know which lap its value belongs to,
+// so the values written to one slot can be popped in any lap order. A value pushed a full lap later may be popped
+// before a value whose producer claimed the slot but has not written it yet, even when one thread pushed both and
+// one thread pops both, so the queue is not FIFO per producer either. Every value is still popped exactly once.
+// A thread that claimed a ticket waits for the thread owning the same slot, so the queue is not lock free when a
+// thread stops between the two steps.
+//
+// `Padded` puts each slot on its own cache line, packed slots use less memory and suit batches.
+template<typename T, typename Traits = tombstone_traits<T>, bool Padded = true>
+class tombstone_mpmc_ring {
+  using atomic_type = atomic_tombstone_optional<T, Traits>;
+  using slot_type   = mpmc_ring_details::Slot<atomic_type, Padded>;
+public:
+  using value_type    = T;
+  using traits_type   = Traits;
+  using optional_type = tombstone_optional<T, Traits>;
+  using size_type     = std::size_t;
+
+  static constexpr bool padded = Padded;
+
+  // `capacity` is rounded up to a power of two
+  explicit tombstone_mpmc_ring(size_type capacity)
+  : mMask(std::bit_ceil(std::max<size_type>(capacity, 1)) - 1)
+  , mSlots(std::make_unique<slot_type[]>(mMask + 1))
+  {
+  }
+
+  tombstone_mpmc_ring(const tombstone_mpmc_ring&)            = delete;
+  tombstone_mpmc_ring& operator=(const tombstone_mpmc_ring&) = delete;
+
+  [[nodiscard]] size_type capacity() const noexcept { return mMask + 1; }
+
+  // the number of claimed tickets, only exact when no other thread is pushing or popping
+  [[nodiscard]] size_type size_approx() const noexcept
+  {
+    const std::uint64_t head = mHead.value.load(std::memory_order_relaxed);
+    const std::uint64_t tail = mTail.value.load(std::memory_order_relaxed);
+    return tail > head ? static_cast<size_type>(tail - head) : 0;
+  }
+
+  // pushes `value` unless the queue is full or `value` is the null state
+  bool try_push(const T& value) noexcept { return try_push_n(std::span<const T>(&value, 1)) == 1; }
+
+  // pops a value unless the queue is empty
+  optional_type try_pop() noexcept
+  {
+    optional_type result;
+    PopN(1, [&](size_type, const T& value) { result = value; });
+    return result;
+  }
+
+  // Pushes the longest prefix of `values` that fits and has no null state and returns its size, the tickets
+  // are claimed with one CAS. A null state would make the slot look empty to the consumer of its ticket.
+  size_type try_push_n(std::span<const T> values) noexcept
+  {
+    values = values.first(static_cast<size_type>(
+      std::ranges::find_if(values, [](const T& value) { return Traits::is_null(value); }) - values.begin()));
+    std::uint64_t tail = mTail.value.load(std::memory_order_relaxed);
+    size_type     count;
+    do {
+      const std::uint64_t head = mHead.value.load(std::memory_order_acquire);
+      // the tail loaded before may be older than the head
+      const auto used = tail > head ? static_cast<size_type>(tail - head) : 0;
+      count           = std::min(values.size(), used < capacity() ? capacity() - used : 0);
+      if (count == 0)
+        return 0;
+    } while (
+      !mTail.value.compare_exchange_weak(tail, tail + count, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    for (size_type i = 0; i < count; ++i) {
+      atomic_type& slot = mSlots[(tail + i) & mMask].value;
+      // the consumer of the previous lap may not have emptied the slot yet
+      mpmc_ring_details::SpinUntil([&] { return slot.try_publish(values[i], std::memory_order_release); });
+    }
+    return count;
+  }
+
+  // pops up to `out.size()` values into `out` and returns how many, the tickets are claimed with one CAS
+  size_type try_pop_n(std::span<T> out) noexcept
+  {
+    return PopN(out.size(), [&](size_type i, const T& value) { out[i] = value; });
+  }
+private:
+  template<typename Sink>
+  size_type PopN(size_type max, Sink&& sink) noexcept
+  {
+    std::uint64_t head = mHead.value.load(std::memory_order_relaxed);
+    size_type     count;
+    do {
+      const std::uint64_t tail = mTail.value.load(std::memory_order_acquire);
+      count                    = std::min(max, tail > head ? static_cast<size_type>(tail - head) : 0);
+      if (count == 0)
+        return 0;
+    } while (
+      !mHead.value.compare_exchange_weak(head, head + count, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+    for (size_type i = 0; i < count; ++i) {
+      atomic_type& slot = mSlots[(head + i) & mMask].value;
+      // the producer that claimed this ticket may not have written it yet
+      mpmc_ring_details::SpinUntil([&] {
+        const optional_type value = slot.take(std::memory_order_acquire);
+        if (value)
+          sink(i, *value);
+        return value.has_value();
+      });
+    }
+    return count;
+  }
+
+  struct alignas(mpmc_ring_details::cache_line) Counter {
+    std::atomic<std::uint64_t> value{0};
+  };
+
+  size_type                    mMask;
+  std::unique_ptr<slot_type[]> mSlots;
+  Counter                      mHead;
+  Counter                      mTail;
+};
+
+} // namespace zxshady
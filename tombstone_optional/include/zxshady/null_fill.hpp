@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <zxshady/optional.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/mman.h>
+  #define ZXSHADY_OPTIONAL_HAS_MMAP 1
+#else
+  #define ZXSHADY_OPTIONAL_HAS_MMAP 0
+#endif
+
+namespace zxshady {
+
+namespace null_fill_details {
+  template<typename Traits, typename T>
+  consteval std::optional<unsigned char> NullByte() noexcept
+  {
+    if constexpr (requires { Traits::null_is_zero_bits; }) {
+      if constexpr (Traits::null_is_zero_bits)
+        return static_cast<unsigned char>(0);
+    }
+    if constexpr (requires { Traits::null_value; }) {
+      using null_type = std::remove_cv_t<decltype(Traits::null_value)>;
+      // pointers cannot be bit_cast at compile time, their traits declare `null_is_zero_bits` instead
+      if constexpr (sizeof(null_type) == sizeof(T) && std::is_trivially_copyable_v<null_type> &&
+                    !std::is_pointer_v<null_type> && !std::is_member_pointer_v<null_type> &&
+                    !std::is_null_pointer_v<null_type> &&
+                    (std::has_unique_object_representations_v<null_type> || std::is_floating_point_v<null_type>)) {
+        const auto bytes = std::bit_cast<std::array<unsigned char, sizeof(T)>>(Traits::null_value);
+        for (const unsigned char byte : bytes)
+          if (byte != bytes[0])
+            return std::nullopt;
+        return bytes[0];
+      }
+    }
+    return std::nullopt;
+  }
+
+  enum class AllocationKind : unsigned char { Malloc, AlignedNew, Mmap };
+
+  // below this calloc is as lazy as it gets, above it fresh anonymous pages are zero and only touched on first use
+  inline constexpr std::size_t mmap_threshold = std::size_t{1} << 20;
+} // namespace null_fill_details
+
+// The byte every byte of the null state of `Traits` is set to, if there is one.
+// Traits declare `static constexpr bool null_is_zero_bits = true;` when their null state is all zero bits,
+// otherwise it is found from a `null_value` that holds the bit pattern of the null state.
+template<typename Traits, typename T>
+inline constexpr std::optional<unsigned char> tombstone_null_byte_v = null_fill_details::NullByte<Traits, T>();
+
+// Starts the lifetime of null optionals in [first, last) with a single `memset` when the null state is a repeated byte
+template<typename T, typename Traits>
+void uninitialized_fill_null(tombstone_optional<T, Traits>* first, tombstone_optional<T, Traits>* last) noexcept
+{
+  constexpr auto null_byte = tombstone_null_byte_v<Traits, T>;
+  if constexpr (null_byte.has_value() && sizeof(tombstone_optional<T, Traits>) == sizeof(T)) {
+    if (first != last)
+      std::memset(static_cast<void*>(first), *null_byte, static_cast<std::size_t>(last - first) * sizeof(T));
+  }
+  else {
+    for (; first != last; ++first)
+      std::construct_at(first);
+  }
+}
+
+template<typename Optional>
+class null_array_deleter {
+public:
+  constexpr null_array_deleter() noexcept = default;
+  constexpr null_array_deleter(std::size_t size, null_fill_details::AllocationKind kind) noexcept
+  : mSize(size)
+  , mKind(kind)
+  {
+  }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return mSize; }
+
+  void operator()(Optional* p) const noexcept
+  {
+    std::destroy(p, p + mSize);
+    switch (mKind) {
+    case null_fill_details::AllocationKind::Malloc: std::free(p); break;
+    case null_fill_details::AllocationKind::AlignedNew:
+      ::operator delete(static_cast<void*>(p), std::align_val_t{alignof(Optional)});
+      break;
+    case null_fill_details::AllocationKind::Mmap:
+#if ZXSHADY_OPTIONAL_HAS_MMAP
+      ::munmap(static_cast<void*>(p), mSize * sizeof(Optional));
+#endif
+      break;
+    }
+  }
+private:
+  std::size_t                       mSize = 0;
+  null_fill_details::AllocationKind mKind = null_fill_details::AllocationKind::Malloc;
+};
+
+template<typename T, typename Traits = tombstone_traits<T>>
+using null_array = std::unique_ptr<tombstone_optional<T, Traits>[], null_array_deleter<tombstone_optional<T, Traits>>>;
+
+// Allocates `count` null optionals. An all zero null state comes from `calloc` or, for large arrays,
+// fresh anonymous pages so nothing is written until an element is used. Other repeated bytes are `memset`.
+// Throws `std::bad_alloc` on failure.
+template<typename T, typename Traits = tombstone_traits<T>>
+[[nodiscard]] null_array<T, Traits> make_null_array(std::size_t count)
+{
+  using optional_type = tombstone_optional<T, Traits>;
+  using null_fill_details::AllocationKind;
+  const auto Adopt = [count](void* p, AllocationKind kind) noexcept {
+    return null_array<T, Traits>(static_cast<optional_type*>(p), null_array_deleter<optional_type>(count, kind));
+  };
+
+  constexpr auto null_byte    = tombstone_null_byte_v<Traits, T>;
+  constexpr bool over_aligned = alignof(optional_type) > alignof(std::max_align_t);
+
+  if (count > std::numeric_limits<std::size_t>::max() / sizeof(optional_type))
+    throw std::bad_alloc();
+  const std::size_t bytes = count * sizeof(optional_type);
+
+  if constexpr (null_byte == static_cast<unsigned char>(0) && sizeof(optional_type) == sizeof(T)) {
+#if ZXSHADY_OPTIONAL_HAS_MMAP
+    if (alignof(optional_type) <= 4096 && bytes >= null_fill_details::mmap_threshold) {
+      void* const p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (p == MAP_FAILED)
+        throw std::bad_alloc();
+      return Adopt(p, AllocationKind::Mmap);
+    }
+#endif
+    if constexpr (!over_aligned) {
+      void* const p = std::calloc(count == 0 ? 1 : count, sizeof(optional_type));
+      if (p == nullptr)
+        throw std::bad_alloc();
+      return Adopt(p, AllocationKind::Malloc);
+    }
+  }
+
+  void*          p;
+  AllocationKind kind;
+  if constexpr (over_aligned) {
+    p    = ::operator new(bytes == 0 ? 1 : bytes, std::align_val_t{alignof(optional_type)});
+    kind = AllocationKind::AlignedNew;
+  }
+  else {
+    p = std::malloc(bytes == 0 ? 1 : bytes);
+    if (p == nullptr)
+      throw std::bad_alloc();
+    kind = AllocationKind::Malloc;
+  }
+  auto* const first = static_cast<optional_type*>(p);
+  uninitialized_fill_null(first, first + count);
+  return Adopt(p, kind);
+}
+
+} // namespace zxshady
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <bit>
+#include <chrono>
 #include <compare>
 #include <concepts>
+#include <cstddef> // std::byte
+#include <cstdint>
 #include <initializer_list>
+#include <limits>
 #include <memory>   // std::addressof std::construct_at
 #include <optional> // std::hash is in here
 #include <type_traits>
@@ -12,6 +17,11 @@
 
   #define ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(x, msg, ...) assert(x&& msg)
 #endif
+// what `std::hash` gives a null optional when the traits do not declare `null_hash`,
+// 0 would collide with the identity hash of 0 that libstdc++ and MSVC use for integers
+#ifndef ZXSHADY_OPTIONAL_TOMBSTONE_NULL_HASH
+  #define ZXSHADY_OPTIONAL_TOMBSTONE_NULL_HASH static_cast<std::size_t>(0x9e37'79b9'7f4a'7c15ull)
+#endif
 #ifndef ZXFWD
   #define ZXFWD(x) static_cast<decltype(x)&&>(x)
 #endif
@@ -29,8 +39,34 @@ namespace concepts {
   concept tombstone_trivial_destroy_traits_for = tombstone_traits_for<Traits, Type> &&
     (!requires(Type& type) { Traits::destroy_null_state(type); });
 
+  // Traits with more than one spare bit pattern ("niches"), niche 0 must be the null state
+  // and `niche_index` returns `niche_count` for values
+  template<typename Traits, typename Type>
+  concept tombstone_niche_traits_for = tombstone_traits_for<Traits, Type> && requires(Type type, const Type ctype) {
+    { Traits::niche_count } -> std::convertible_to<std::size_t>;
+    { Traits::niche_index(ctype) } noexcept -> std::same_as<std::size_t>;
+    { Traits::initialize_niche(type, std::size_t{}) } noexcept;
+  };
+
 } // namespace concepts
 
+template<typename Traits, typename T>
+inline constexpr std::size_t tombstone_niche_count_v = [] {
+  if constexpr (concepts::tombstone_niche_traits_for<Traits, T>)
+    return std::size_t{Traits::niche_count};
+  else
+    return std::size_t{1};
+}();
+
+// the hash of a null optional, `Traits::null_hash` if the traits declare it
+template<typename Traits>
+inline constexpr std::size_t tombstone_null_hash_v = [] {
+  if constexpr (requires { Traits::null_hash; })
+    return static_cast<std::size_t>(Traits::null_hash);
+  else
+    return ZXSHADY_OPTIONAL_TOMBSTONE_NULL_HASH;
+}();
+
 
 namespace tombstone_optional_details {
   template<typename T>
@@ -69,6 +105,132 @@ namespace tombstone_optional_details {
   template<typename T>
   concept TombstoneOptionalConvertible = requires(T u) { TombstoneOptionalConvertibleTest(u); };
 
+
+  template<typename Traits, typename T>
+  constexpr std::size_t NicheIndex(const T& x) noexcept
+  {
+    if constexpr (concepts::tombstone_niche_traits_for<Traits, T>)
+      return Traits::niche_index(x);
+    else
+      return Traits::is_null(x) ? 0 : 1;
+  }
+
+  template<typename Traits, typename T>
+  constexpr void InitializeNiche(T& x, [[maybe_unused]] std::size_t index) noexcept
+  {
+    if constexpr (concepts::tombstone_niche_traits_for<Traits, T>)
+      Traits::initialize_niche(x, index);
+    else
+      Traits::initialize_null_state(x);
+  }
+
+  template<std::size_t Size>
+  struct UnsignedOfSize;
+  template<>
+  struct UnsignedOfSize<1> {
+    using type = std::uint8_t;
+  };
+  template<>
+  struct UnsignedOfSize<2> {
+    using type = std::uint16_t;
+  };
+  template<>
+  struct UnsignedOfSize<4> {
+    using type = std::uint32_t;
+  };
+  template<>
+  struct UnsignedOfSize<8> {
+    using type = std::uint64_t;
+  };
+
+  template<typename M>
+  struct MemberPointer;
+  template<typename C, typename M>
+  struct MemberPointer<M C::*> {
+    using class_type  = C;
+    using member_type = M;
+  };
+
+  template<auto Member, typename MemberTraits, typename = void>
+  struct MemberNiches {};
+
+  template<auto Member, typename MemberTraits>
+    requires concepts::tombstone_niche_traits_for<MemberTraits, typename MemberPointer<decltype(Member)>::member_type>
+  struct MemberNiches<Member, MemberTraits> {
+  private:
+    using class_type = typename MemberPointer<decltype(Member)>::class_type;
+  public:
+    static constexpr std::size_t niche_count = MemberTraits::niche_count;
+
+    static constexpr std::size_t niche_index(const class_type& x) noexcept { return MemberTraits::niche_index(x.*Member); }
+    static constexpr void        initialize_niche(class_type& x, std::size_t index) noexcept
+    {
+      MemberTraits::initialize_niche(x.*Member, index);
+    }
+  };
+
+  // for traits and adaptors that need to see through a `tombstone_optional`
+  struct Access {
+    template<typename Optional>
+    static constexpr auto& Value(Optional& o) noexcept
+    {
+      return o.mValue;
+    }
+
+    // begins the lifetime of `o` in one of the spare niches of its traits, niches are never values so
+    // they cannot be reached through the public interface. the traits must not define `destroy_null_state`
+    template<typename Optional>
+    static constexpr void InitializeNiche(Optional& o, std::size_t index) noexcept
+    {
+      std::construct_at(std::addressof(o));
+      tombstone_optional_details::InitializeNiche<typename Optional::traits_type>(o.mValue, index);
+    }
+  };
+
+
+  // Traits declare `null_orders_first` when the null state compares below every value of `T`
+  // and `null_orders_last` when it compares above them
+  template<typename Traits>
+  concept NullOrdersFirst = requires { requires bool{Traits::null_orders_first}; };
+
+  template<typename Traits>
+  concept NullOrdersLast = requires { requires bool{Traits::null_orders_last}; };
+
+  template<auto Value>
+  constexpr bool IsMin() noexcept
+  {
+    using type = decltype(Value);
+    if constexpr (std::is_integral_v<type> && !std::is_same_v<type, bool>)
+      return Value == std::numeric_limits<type>::min();
+    else
+      return false;
+  }
+
+  template<auto Value>
+  constexpr bool IsMax() noexcept
+  {
+    using type = decltype(Value);
+    if constexpr (std::is_integral_v<type> && !std::is_same_v<type, bool>)
+      return Value == std::numeric_limits<type>::max();
+    else
+      return false;
+  }
+
+
+  // compares the bits instead of using `==` since NaN != NaN
+  template<typename Float, typename Bits, Bits Pattern>
+  struct NanPatternTraits {
+    static_assert(std::numeric_limits<Float>::is_iec559 && sizeof(Float) == sizeof(Bits));
+
+    static constexpr Bits null_value = Pattern;
+
+    static constexpr void initialize_null_state(Float& x) noexcept
+    {
+      std::construct_at(std::addressof(x), std::bit_cast<Float>(Pattern));
+    }
+    static constexpr bool is_null(const Float& x) noexcept { return std::bit_cast<Bits>(x) == Pattern; }
+  };
+
 } // namespace tombstone_optional_details
 
 
@@ -84,8 +246,12 @@ private:
 
 
 public:
-  static void initialize_null_state(type& x) noexcept { ::new (&x) type(Value); }
-  static bool is_null(const type& x) noexcept { return x == Value; }
+  static constexpr type null_value        = Value;
+  static constexpr bool null_orders_first = tombstone_optional_details::IsMin<Value>();
+  static constexpr bool null_orders_last  = tombstone_optional_details::IsMax<Value>();
+
+  static constexpr void initialize_null_state(type& x) noexcept { std::construct_at(std::addressof(x), Value); }
+  static constexpr bool is_null(const type& x) noexcept { return x == Value; }
 
   static void destroy_null_state(type& x) noexcept
     requires(!std::is_trivially_destructible_v<type>)
@@ -99,6 +265,186 @@ struct tombstone_traits<bool> {
   static constexpr unsigned char null_value = 0xff;
   static void                    initialize_null_state(bool& x) noexcept { ::new (&x) unsigned char(null_value); }
   static bool is_null(const bool& x) noexcept { return reinterpret_cast<const unsigned char&>(x) == null_value; }
+
+  // every byte except 0 and 1, counting down from 0xff
+  static constexpr std::size_t niche_count = 254;
+  static std::size_t           niche_index(const bool& x) noexcept
+  {
+    const std::size_t index = static_cast<unsigned char>(null_value - reinterpret_cast<const unsigned char&>(x));
+    return index < niche_count ? index : niche_count;
+  }
+  static void initialize_niche(bool& x, std::size_t index) noexcept
+  {
+    ::new (&x) unsigned char(static_cast<unsigned char>(null_value - index));
+  }
+};
+
+// the values from `Lo` to `Hi` inclusive are niches and `Lo` is the null state
+template<auto Lo, decltype(Lo) Hi>
+struct tombstone_range_pattern {
+private:
+  using type = decltype(Lo);
+  static_assert((std::is_integral_v<type> || std::is_enum_v<type>) && !std::is_same_v<type, bool>,
+                "tombstone_range_pattern only works with integers and enums");
+
+  using underlying_type = typename std::conditional_t<std::is_enum_v<type>,
+                                                      std::underlying_type<type>,
+                                                      std::type_identity<type>>::type;
+  using unsigned_type   = std::make_unsigned_t<underlying_type>;
+
+  static constexpr unsigned_type ToUnsigned(type x) noexcept
+  {
+    return static_cast<unsigned_type>(static_cast<underlying_type>(x));
+  }
+
+  static_assert(static_cast<underlying_type>(Lo) <= static_cast<underlying_type>(Hi), "Lo must not be greater than Hi");
+  static_assert(static_cast<unsigned_type>(ToUnsigned(Hi) - ToUnsigned(Lo)) < std::numeric_limits<std::size_t>::max(),
+                "the range is too large to be counted");
+public:
+  static constexpr type        null_value        = Lo;
+  static constexpr std::size_t niche_count       = static_cast<std::size_t>(ToUnsigned(Hi) - ToUnsigned(Lo)) + 1;
+  static constexpr bool        null_orders_first = tombstone_optional_details::IsMin<Lo>();
+
+  static constexpr void initialize_null_state(type& x) noexcept { std::construct_at(std::addressof(x), Lo); }
+  static constexpr bool is_null(const type& x) noexcept { return x == Lo; }
+
+  static constexpr std::size_t niche_index(const type& x) noexcept
+  {
+    const auto offset = static_cast<std::size_t>(static_cast<unsigned_type>(ToUnsigned(x) - ToUnsigned(Lo)));
+    return offset < niche_count ? offset : niche_count;
+  }
+  static constexpr void initialize_niche(type& x, std::size_t index) noexcept
+  {
+    const auto bits = static_cast<unsigned_type>(ToUnsigned(Lo) + index);
+    std::construct_at(std::addressof(x), static_cast<type>(static_cast<underlying_type>(bits)));
+  }
+};
+
+namespace tombstone_optional_details {
+  template<typename T>
+  concept Integer = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, std::byte>;
+
+  // `std::numeric_limits<std::byte>` is not specialized
+  template<typename T>
+  using IntegerLimits = std::numeric_limits<std::conditional_t<std::is_same_v<T, std::byte>, unsigned char, T>>;
+} // namespace tombstone_optional_details
+
+// every bit pattern of an integer or a `std::byte` is a valid value so stealing one is opt-in
+template<typename T>
+  requires tombstone_optional_details::Integer<T>
+using tombstone_min_traits = tombstone_value_pattern<static_cast<T>(tombstone_optional_details::IntegerLimits<T>::min())>;
+
+template<typename T>
+  requires tombstone_optional_details::Integer<T>
+using tombstone_max_traits = tombstone_value_pattern<static_cast<T>(tombstone_optional_details::IntegerLimits<T>::max())>;
+
+template<typename T>
+struct tombstone_traits<T*> {
+  static constexpr T* null_value = nullptr;
+  // every supported platform represents nullptr with zero bits
+  static constexpr bool null_is_zero_bits = true;
+
+  static constexpr void initialize_null_state(T*& x) noexcept { std::construct_at(std::addressof(x), nullptr); }
+  static constexpr bool is_null(T* const& x) noexcept { return x == nullptr; }
+};
+
+// a signalling NaN with a payload no arithmetic produces, quiet NaNs and `signaling_NaN()` stay valid values
+template<>
+struct tombstone_traits<float> : tombstone_optional_details::NanPatternTraits<float, std::uint32_t, 0x7f80'0001> {};
+
+template<>
+struct tombstone_traits<double>
+: tombstone_optional_details::NanPatternTraits<double, std::uint64_t, 0x7ff0'0000'0000'0001> {};
+
+template<typename Rep, typename Period>
+struct tombstone_traits<std::chrono::duration<Rep, Period>> {
+private:
+  using type = std::chrono::duration<Rep, Period>;
+public:
+  static constexpr void initialize_null_state(type& x) noexcept { std::construct_at(std::addressof(x), type::max()); }
+  static constexpr bool is_null(const type& x) noexcept { return x == type::max(); }
+};
+
+template<typename Clock, typename Duration>
+struct tombstone_traits<std::chrono::time_point<Clock, Duration>> {
+private:
+  using type = std::chrono::time_point<Clock, Duration>;
+public:
+  static constexpr void initialize_null_state(type& x) noexcept { std::construct_at(std::addressof(x), type::max()); }
+  static constexpr bool is_null(const type& x) noexcept { return x == type::max(); }
+};
+
+// The bits in `Mask` are never set by a value of `T`, for example the low bits of an aligned pointer
+// or the high bits of a bounded index. Niche k sets those bits to k + 1 and clears the others
+// so every value of `T` including `nullptr` and `0` stays valid.
+template<typename T, unsigned long long Mask>
+struct tombstone_spare_bits {
+private:
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+  using bits_type = typename tombstone_optional_details::UnsignedOfSize<sizeof(T)>::type;
+
+  static constexpr bits_type mask  = static_cast<bits_type>(Mask);
+  static constexpr int       shift = std::countr_zero(mask);
+
+  static_assert(mask != 0 && mask == Mask, "Mask must be a non empty mask of the bits of T");
+  static_assert(((mask >> shift) & ((mask >> shift) + 1)) == 0, "the bits in Mask must be contiguous");
+
+  static constexpr bits_type Bits(const T& x) noexcept { return std::bit_cast<bits_type>(x); }
+public:
+  static constexpr bits_type   null_value  = bits_type{1} << shift;
+  static constexpr std::size_t niche_count = static_cast<std::size_t>(mask >> shift);
+
+  static constexpr void initialize_null_state(T& x) noexcept
+  {
+    std::construct_at(std::addressof(x), std::bit_cast<T>(null_value));
+  }
+  static constexpr bool is_null(const T& x) noexcept { return Bits(x) == null_value; }
+
+  static constexpr std::size_t niche_index(const T& x) noexcept
+  {
+    const bits_type bits  = Bits(x);
+    const auto      index = static_cast<bits_type>((bits >> shift) - 1);
+    return (bits & ~mask) == 0 && index < niche_count ? index : niche_count;
+  }
+  static constexpr void initialize_niche(T& x, std::size_t index) noexcept
+  {
+    std::construct_at(std::addressof(x), std::bit_cast<T>(static_cast<bits_type>((index + 1) << shift)));
+  }
+};
+
+// the low bits every `T*` leaves clear
+template<typename T>
+using tombstone_alignment_bits = tombstone_spare_bits<T*, alignof(T) - 1>;
+
+// Delegates to the traits of a single member so only that member's bytes are touched, the rest of
+// the object is left uninitialized in the null state and its constructors never run.
+// The member must be the first one of a standard layout class. The null state is then the member
+// at offset 0 of storage that never held the class, which the standard leaves undefined for classes
+// that are not implicit lifetime types but every supported ABI lays out and reads back as expected.
+template<auto Member,
+         typename MemberTraits =
+           tombstone_traits<typename tombstone_optional_details::MemberPointer<decltype(Member)>::member_type>>
+struct tombstone_member_traits : tombstone_optional_details::MemberNiches<Member, MemberTraits> {
+private:
+  using class_type  = typename tombstone_optional_details::MemberPointer<decltype(Member)>::class_type;
+  using member_type = typename tombstone_optional_details::MemberPointer<decltype(Member)>::member_type;
+  static_assert(std::is_member_object_pointer_v<decltype(Member)>, "Member must be a pointer to a data member");
+  static_assert(concepts::tombstone_traits_for<MemberTraits, member_type>,
+                "MemberTraits must be a tombstone_traits class for the member");
+  static_assert(std::is_standard_layout_v<class_type>, "the class must be standard layout");
+#if defined(__cpp_lib_is_pointer_interconvertible)
+  static_assert(std::is_pointer_interconvertible_with_class(Member), "Member must be the first member of the class");
+#endif
+public:
+  static constexpr void initialize_null_state(class_type& x) noexcept { MemberTraits::initialize_null_state(x.*Member); }
+  static constexpr bool is_null(const class_type& x) noexcept { return MemberTraits::is_null(x.*Member); }
+
+  static constexpr void destroy_null_state(class_type& x) noexcept
+    requires(!concepts::tombstone_trivial_destroy_traits_for<MemberTraits, member_type>)
+  {
+    MemberTraits::destroy_null_state(x.*Member);
+  }
 };
 
 template<typename T, typename Traits>
@@ -123,8 +469,8 @@ public:
   explicit(!std::is_convertible_v<U, T>) constexpr tombstone_optional(U&& u) noexcept(std::is_nothrow_constructible_v<T, U>)
   : mValue(ZXFWD(u))
   {
-    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(mValue),
-                                      "\"u\" cannot be the null state value for `zxshady::optional_tombstone`",
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(IsValue(mValue),
+                                      "\"u\" cannot be the null state or a niche of `zxshady::optional_tombstone`",
                                       mValue);
   }
 
@@ -134,8 +480,8 @@ public:
     std::is_nothrow_constructible_v<T, Args...>)
   : mValue(ilist, ZXFWD(args)...)
   {
-    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(mValue),
-                                      "T(args...) cannot be the null state value for `zxshady::optional_tombstone`",
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(IsValue(mValue),
+                                      "T(args...) cannot be the null state or a niche of `zxshady::optional_tombstone`",
                                       mValue);
   }
 
@@ -144,8 +490,8 @@ public:
   explicit constexpr tombstone_optional(std::in_place_t, Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
   : mValue(ZXFWD(args)...)
   {
-    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(mValue),
-                                      "T(args...) cannot be the null state value for `zxshady::optional_tombstone`",
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(IsValue(mValue),
+                                      "T(args...) cannot be the null state or a niche of `zxshady::optional_tombstone`",
                                       mValue);
   }
 
@@ -254,8 +600,8 @@ public:
       Traits::destroy_null_state(mValue);
 
     std::construct_at(std::addressof(mValue), ZXFWD(args)...);
-    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(mValue),
-                                      "Setting null value in emplace uninteded use `.reset()` instead",
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(IsValue(mValue),
+                                      "Setting null value or a niche in emplace uninteded use `.reset()` instead",
                                       mValue);
     return mValue;
   }
@@ -269,8 +615,8 @@ public:
     else if constexpr (!trivial_null_destroyer)
       Traits::destroy_null_state(mValue);
     std::construct_at(std::addressof(mValue), ilist, ZXFWD(args)...);
-    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(mValue),
-                                      "Setting null value in emplace uninteded use `.reset()` instead",
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(IsValue(mValue),
+                                      "Setting null value or a niche in emplace uninteded use `.reset()` instead",
                                       mValue);
     return mValue;
   }
@@ -370,6 +716,12 @@ public:
 private:
   static constexpr bool trivial_null_destroyer = concepts::tombstone_trivial_destroy_traits_for<Traits, T>;
 
+  // the null state and every spare niche are reserved, only the last niche index is a value
+  static constexpr bool IsValue(const T& x) noexcept
+  {
+    return tombstone_optional_details::NicheIndex<Traits>(x) == tombstone_niche_count_v<Traits, T>;
+  }
+
   template<typename U>
   constexpr void Assign(U&& u) noexcept(std::is_nothrow_assignable_v<T, U> && std::is_nothrow_constructible_v<T, U>)
   {
@@ -381,20 +733,52 @@ private:
         Traits::destroy_null_state(mValue);
       std::construct_at(std::addressof(mValue), ZXFWD(u));
     }
-    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(mValue),
-                                      "Cannot set an optional with the null value! use .reset instead",
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(IsValue(mValue),
+                                      "Cannot set an optional with the null value or a niche! use .reset instead",
                                       mValue);
   }
 
   template<typename U, typename UTraits>
   friend class tombstone_optional;
 
+  friend struct tombstone_optional_details::Access;
+
   union {
     std::remove_cv_t<T> mValue;
   };
 };
 
 
+// a `tombstone_optional` uses niche 0 of its traits and hands the remaining ones to the next layer
+template<typename T, typename Traits>
+  requires(tombstone_niche_count_v<Traits, T> >= 2) && concepts::tombstone_trivial_destroy_traits_for<Traits, T>
+struct tombstone_traits<tombstone_optional<T, Traits>> {
+private:
+  using type = tombstone_optional<T, Traits>;
+
+  static constexpr std::size_t InnerIndex(const type& x) noexcept
+  {
+    return tombstone_optional_details::NicheIndex<Traits>(tombstone_optional_details::Access::Value(x));
+  }
+public:
+  static constexpr std::size_t niche_count = tombstone_niche_count_v<Traits, T> - 1;
+
+  static constexpr void initialize_null_state(type& x) noexcept { initialize_niche(x, 0); }
+  static constexpr bool is_null(const type& x) noexcept { return InnerIndex(x) == 1; }
+
+  static constexpr std::size_t niche_index(const type& x) noexcept
+  {
+    // the inner null state wraps around to a value
+    const std::size_t index = InnerIndex(x) - 1;
+    return index < niche_count ? index : niche_count;
+  }
+  static constexpr void initialize_niche(type& x, std::size_t index) noexcept
+  {
+    tombstone_optional_details::Access::InitializeNiche(x, index + 1);
+  }
+};
+
+
 template<typename T, typename Traits>
 [[nodiscard]] constexpr bool operator==(const tombstone_optional<T, Traits>& a, std::nullopt_t) noexcept
 {
@@ -436,9 +820,17 @@ template<typename T, typename Traits, std::three_way_comparable_with<T> U, typen
   const tombstone_optional<T, Traits>&  a,
   const tombstone_optional<U, UTraits>& b) noexcept(noexcept(*a <=> *b))
 {
-  const bool a_has_value = a.has_value();
-  const bool b_has_value = b.has_value();
-  return a_has_value && b_has_value ? *a <=> *b : a_has_value <=> b_has_value;
+  if constexpr (std::is_same_v<T, U> && std::is_same_v<Traits, UTraits> &&
+                tombstone_optional_details::NullOrdersFirst<Traits>) {
+    // the null state already sorts before every value
+    using tombstone_optional_details::Access;
+    return Access::Value(a) <=> Access::Value(b);
+  }
+  else {
+    const bool a_has_value = a.has_value();
+    const bool b_has_value = b.has_value();
+    return a_has_value && b_has_value ? *a <=> *b : a_has_value <=> b_has_value;
+  }
 }
 
 
@@ -453,7 +845,7 @@ template<typename T, typename Traits>
 struct hash<zxshady::tombstone_optional<T, Traits>> {
   constexpr size_t operator()(const zxshady::tombstone_optional<T, Traits>& opt) const noexcept(noexcept(hash<T>()(*opt)))
   {
-    return opt ? hash<T>()(*opt) : 0;
+    return opt ? hash<T>()(*opt) : zxshady::tombstone_null_hash_v<Traits>;
   }
 };
 
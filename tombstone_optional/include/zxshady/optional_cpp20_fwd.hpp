@@ -8,6 +8,12 @@ struct tombstone_traits;
 template<auto Value>
 struct tombstone_value_pattern;
 
+template<auto Lo, decltype(Lo) Hi>
+struct tombstone_range_pattern;
+
+template<typename T, unsigned long long Mask>
+struct tombstone_spare_bits;
+
 template<typename T, typename Traits = tombstone_traits<T>>
 class tombstone_optional;
 
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <zxshady/null_fill.hpp>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+// A fixed capacity pool of `T` whose free list is threaded through the niches of `Traits`, so there is no
+// memory besides the slots. A free slot holds niche 0, the null state, when the next free slot follows it and
+// niche `k + 1` when it is slot `k`, which needs `niche_count >= capacity + 2`. Every niche is a free slot.
+template<typename T, typename Traits = tombstone_traits<T>>
+class tombstone_pool {
+  static_assert(concepts::tombstone_niche_traits_for<Traits, T> && tombstone_niche_count_v<Traits, T> >= 3,
+                "Traits must have niches to hold the free list");
+  static_assert(concepts::tombstone_trivial_destroy_traits_for<Traits, T>,
+                "Traits must not define destroy_null_state, free slots are not destroyed");
+public:
+  using value_type    = T;
+  using traits_type   = Traits;
+  using optional_type = tombstone_optional<T, Traits>;
+  using size_type     = std::size_t;
+
+  static_assert(sizeof(optional_type) == sizeof(T));
+
+  // the largest capacity the niches of `Traits` can link
+  static constexpr size_type max_capacity = tombstone_niche_count_v<Traits, T> - 2;
+
+  explicit tombstone_pool(size_type capacity) : mCapacity(capacity)
+  {
+    if (capacity > max_capacity)
+      throw std::length_error("tombstone_pool capacity is larger than the niches of Traits can link");
+    mSlots = std::allocator<optional_type>().allocate(capacity);
+    uninitialized_fill_null(mSlots, mSlots + capacity);
+  }
+
+  tombstone_pool(const tombstone_pool&)            = delete;
+  tombstone_pool& operator=(const tombstone_pool&) = delete;
+
+  tombstone_pool(tombstone_pool&& that) noexcept
+  : mSlots(std::exchange(that.mSlots, nullptr))
+  , mCapacity(std::exchange(that.mCapacity, 0))
+  , mSize(std::exchange(that.mSize, 0))
+  , mFreeHead(std::exchange(that.mFreeHead, 0))
+  {
+  }
+
+  tombstone_pool& operator=(tombstone_pool&& that) noexcept
+  {
+    tombstone_pool(std::move(that)).swap(*this);
+    return *this;
+  }
+
+  ~tombstone_pool()
+  {
+    if (!mSlots)
+      return;
+    DestroyLive();
+    std::allocator<optional_type>().deallocate(mSlots, mCapacity);
+  }
+
+  [[nodiscard]] size_type capacity() const noexcept { return mCapacity; }
+  [[nodiscard]] size_type size() const noexcept { return mSize; }
+  [[nodiscard]] bool      empty() const noexcept { return mSize == 0; }
+  [[nodiscard]] bool      full() const noexcept { return mSize == mCapacity; }
+
+  // Constructs a `T` in a free slot, nullptr when the pool is full. Throws `std::invalid_argument` when
+  // the new object is a niche of `Traits`, it would read back as a link of the free list.
+  template<typename... Args>
+    requires std::constructible_from<T, Args...>
+  [[nodiscard]] T* create(Args&&... args)
+  {
+    if (mFreeHead == mCapacity)
+      return nullptr;
+    const size_type index = mFreeHead;
+    const size_type next  = Next(index);
+    if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+      std::construct_at(std::addressof(Value(index)), ZXFWD(args)...);
+    }
+    else {
+      try {
+        std::construct_at(std::addressof(Value(index)), ZXFWD(args)...);
+      }
+      catch (...) {
+        // the constructor may have written over the link
+        Link(index, next);
+        throw;
+      }
+    }
+    if (!Live(index)) {
+      std::destroy_at(std::addressof(Value(index)));
+      Link(index, next);
+      throw std::invalid_argument("tombstone_pool::create of an object that is a niche of Traits");
+    }
+    mFreeHead = next;
+    ++mSize;
+    return std::addressof(Value(index));
+  }
+
+  // destroys an object from `create` and puts its slot on top of the free list
+  void destroy(T* p) noexcept
+  {
+    const size_type index = index_of(p);
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(Live(index), "tombstone_pool::destroy of a free slot");
+    std::destroy_at(p);
+    Link(index, mFreeHead);
+    mFreeHead = index;
+    --mSize;
+  }
+
+  // the slot of an object from this pool
+  [[nodiscard]] size_type index_of(const T* p) const noexcept
+  {
+    const auto offset = reinterpret_cast<const unsigned char*>(p) - reinterpret_cast<const unsigned char*>(mSlots);
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(offset >= 0 && static_cast<size_type>(offset) < mCapacity * sizeof(T),
+                                      "the object is not from this pool");
+    return static_cast<size_type>(offset) / sizeof(T);
+  }
+
+  // calls `fn(T&)` for every live object in slot order, free slots are skipped
+  template<typename F>
+  void for_each_live(F&& fn)
+  {
+    for (size_type i = 0; i < mCapacity; ++i)
+      if (Live(i))
+        fn(Value(i));
+  }
+  template<typename F>
+  void for_each_live(F&& fn) const
+  {
+    for (size_type i = 0; i < mCapacity; ++i)
+      if (Live(i))
+        fn(std::as_const(Value(i)));
+  }
+
+  // Destroys the live objects and frees every slot. All slots become the null state, that is a free list
+  // in slot order, so this is a single `memset` when the null state is a repeated byte.
+  void clear() noexcept
+  {
+    DestroyLive();
+    uninitialized_fill_null(mSlots, mSlots + mCapacity);
+    mSize     = 0;
+    mFreeHead = 0;
+  }
+
+  void swap(tombstone_pool& that) noexcept
+  {
+    std::swap(mSlots, that.mSlots);
+    std::swap(mCapacity, that.mCapacity);
+    std::swap(mSize, that.mSize);
+    std::swap(mFreeHead, that.mFreeHead);
+  }
+
+  friend void swap(tombstone_pool& a, tombstone_pool& b) noexcept { a.swap(b); }
+private:
+  T&       Value(size_type i) noexcept { return tombstone_optional_details::Access::Value(mSlots[i]); }
+  const T& Value(size_type i) const noexcept { return tombstone_optional_details::Access::Value(mSlots[i]); }
+
+  [[nodiscard]] bool Live(size_type i) const noexcept
+  {
+    return tombstone_optional_details::NicheIndex<Traits>(Value(i)) == tombstone_niche_count_v<Traits, T>;
+  }
+
+  // the free slot after the free slot `i`
+  [[nodiscard]] size_type Next(size_type i) const noexcept
+  {
+    const size_type niche = tombstone_optional_details::NicheIndex<Traits>(Value(i));
+    return niche == 0 ? i + 1 : niche - 1;
+  }
+
+  void Link(size_type i, size_type next) noexcept
+  {
+    tombstone_optional_details::Access::InitializeNiche(mSlots[i], next == i + 1 ? 0 : next + 1);
+  }
+
+  void DestroyLive() noexcept
+  {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_type i = 0; i < mCapacity; ++i)
+        if (Live(i))
+          std::destroy_at(std::addressof(Value(i)));
+    }
+  }
+
+  optional_type* mSlots    = nullptr;
+  size_type      mCapacity = 0;
+  size_type      mSize     = 0;
+  size_type      mFreeHead = 0;
+};
+
+} // namespace zxshady
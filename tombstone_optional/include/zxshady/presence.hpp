@@ -0,0 +1,369 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <zxshady/optional.hpp>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+  #include <immintrin.h>
+  #define ZXSHADY_OPTIONAL_PRESENCE_X86 1
+#else
+  #define ZXSHADY_OPTIONAL_PRESENCE_X86 0
+#endif
+
+namespace zxshady {
+
+namespace presence_details {
+  // The bits of the null state when `is_null(x)` is exactly "the bits of x equal the pattern",
+  // that holds for traits declaring `null_is_zero_bits` and for a non floating point `null_value` of the same size.
+  template<typename Traits, typename T>
+  consteval auto NullPattern() noexcept
+  {
+    using bits_type = typename tombstone_optional_details::UnsignedOfSize<sizeof(T)>::type;
+    if constexpr (requires { Traits::null_is_zero_bits; }) {
+      if constexpr (Traits::null_is_zero_bits)
+        return std::optional<bits_type>(bits_type{0});
+    }
+    if constexpr (requires { Traits::null_value; }) {
+      using null_type = std::remove_cv_t<decltype(Traits::null_value)>;
+      if constexpr (sizeof(null_type) == sizeof(T) && std::is_trivially_copyable_v<null_type> &&
+                    std::has_unique_object_representations_v<null_type> && !std::is_pointer_v<null_type> &&
+                    !std::is_member_pointer_v<null_type>)
+        return std::optional<bits_type>(std::bit_cast<bits_type>(Traits::null_value));
+    }
+    return std::optional<bits_type>();
+  }
+
+  template<typename Traits, typename T>
+  concept HasNullPattern = (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) &&
+    requires { requires NullPattern<Traits, T>().has_value(); };
+
+  enum class Scan { CountNulls, FirstPresent, FirstNull, Bitmap };
+
+  // Folds the null mask of a block of 64 elements into `result`, returns true when the scan is done
+  template<Scan Op>
+  [[gnu::always_inline]] inline bool Consume(std::uint64_t                  nulls,
+                                             [[maybe_unused]] std::size_t    block,
+                                             [[maybe_unused]] std::size_t&   result,
+                                             [[maybe_unused]] std::uint64_t* out) noexcept
+  {
+    if constexpr (Op == Scan::CountNulls) {
+      result += static_cast<std::size_t>(std::popcount(nulls));
+      return false;
+    }
+    else if constexpr (Op == Scan::Bitmap) {
+      out[block] = ~nulls;
+      return false;
+    }
+    else {
+      const std::uint64_t hits = Op == Scan::FirstNull ? nulls : ~nulls;
+      if (hits == 0)
+        return false;
+      result = block * 64 + static_cast<std::size_t>(std::countr_zero(hits));
+      return true;
+    }
+  }
+
+  template<Scan Op>
+  constexpr std::size_t InitialResult(std::size_t blocks) noexcept
+  {
+    return Op == Scan::CountNulls || Op == Scan::Bitmap ? 0 : blocks * 64;
+  }
+
+  // scans `blocks` blocks of 64 elements of `Size` bytes
+  using Kernel = std::size_t (*)(const unsigned char*, std::size_t, std::uint64_t, std::uint64_t*) noexcept;
+
+#if ZXSHADY_OPTIONAL_PRESENCE_X86
+  // SSE2 is part of x86-64 so this is the baseline
+  template<std::size_t Size>
+  inline std::uint64_t NullMaskSse2(const unsigned char* p, __m128i pattern) noexcept
+  {
+    const auto Load = [p](std::size_t i) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p) + i); };
+    std::uint64_t mask = 0;
+    if constexpr (Size == 1) {
+      for (std::size_t i = 0; i < 4; ++i)
+        mask |= std::uint64_t(std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(Load(i), pattern)))) << (16 * i);
+    }
+    else if constexpr (Size == 2) {
+      for (std::size_t i = 0; i < 4; ++i) {
+        const __m128i packed =
+          _mm_packs_epi16(_mm_cmpeq_epi16(Load(2 * i), pattern), _mm_cmpeq_epi16(Load(2 * i + 1), pattern));
+        mask |= std::uint64_t(std::uint32_t(_mm_movemask_epi8(packed))) << (16 * i);
+      }
+    }
+    else if constexpr (Size == 4) {
+      for (std::size_t i = 0; i < 16; ++i)
+        mask |= std::uint64_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(Load(i), pattern)))) << (4 * i);
+    }
+    else {
+      // no 64 bit compare before SSE4.1, both halves have to match
+      for (std::size_t i = 0; i < 32; ++i) {
+        const __m128i halves = _mm_cmpeq_epi32(Load(i), pattern);
+        const __m128i both   = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        mask |= std::uint64_t(_mm_movemask_pd(_mm_castsi128_pd(both))) << (2 * i);
+      }
+    }
+    return mask;
+  }
+
+  template<std::size_t Size>
+  inline __m128i SplatSse2(std::uint64_t pattern) noexcept
+  {
+    if constexpr (Size == 1)
+      return _mm_set1_epi8(static_cast<char>(pattern));
+    else if constexpr (Size == 2)
+      return _mm_set1_epi16(static_cast<short>(pattern));
+    else if constexpr (Size == 4)
+      return _mm_set1_epi32(static_cast<int>(pattern));
+    else
+      return _mm_set1_epi64x(static_cast<long long>(pattern));
+  }
+
+  template<Scan Op, std::size_t Size>
+  std::size_t ScanSse2(const unsigned char* p, std::size_t blocks, std::uint64_t pattern, std::uint64_t* out) noexcept
+  {
+    const __m128i splat  = SplatSse2<Size>(pattern);
+    std::size_t   result = InitialResult<Op>(blocks);
+    for (std::size_t block = 0; block < blocks; ++block, p += 64 * Size)
+      if (Consume<Op>(NullMaskSse2<Size>(p, splat), block, result, out))
+        break;
+    return result;
+  }
+
+  template<std::size_t Size>
+  [[gnu::target("avx2")]] inline std::uint64_t NullMaskAvx2(const unsigned char* p, __m256i pattern) noexcept
+  {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < 2 * Size; ++i) {
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p) + i);
+      if constexpr (Size == 1) {
+        mask |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, pattern)))) << (32 * i);
+      }
+      else if constexpr (Size == 2) {
+        // two registers are packed into one, packs works per 128 bit lane so the quarters are put back in order
+        if (i % 2 == 1)
+          continue;
+        const __m256i y      = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p) + i + 1);
+        const __m256i packed = _mm256_packs_epi16(_mm256_cmpeq_epi16(x, pattern), _mm256_cmpeq_epi16(y, pattern));
+        const __m256i ordered = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        mask |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(ordered))) << (16 * i);
+      }
+      else if constexpr (Size == 4) {
+        mask |= std::uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, pattern)))) << (8 * i);
+      }
+      else {
+        mask |= std::uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, pattern)))) << (4 * i);
+      }
+    }
+    return mask;
+  }
+
+  template<std::size_t Size>
+  [[gnu::target("avx2")]] inline __m256i SplatAvx2(std::uint64_t pattern) noexcept
+  {
+    if constexpr (Size == 1)
+      return _mm256_set1_epi8(static_cast<char>(pattern));
+    else if constexpr (Size == 2)
+      return _mm256_set1_epi16(static_cast<short>(pattern));
+    else if constexpr (Size == 4)
+      return _mm256_set1_epi32(static_cast<int>(pattern));
+    else
+      return _mm256_set1_epi64x(static_cast<long long>(pattern));
+  }
+
+  template<Scan Op, std::size_t Size>
+  [[gnu::target("avx2")]] std::size_t ScanAvx2(const unsigned char* p,
+                                               std::size_t          blocks,
+                                               std::uint64_t        pattern,
+                                               std::uint64_t*       out) noexcept
+  {
+    const __m256i splat  = SplatAvx2<Size>(pattern);
+    std::size_t   result = InitialResult<Op>(blocks);
+    for (std::size_t block = 0; block < blocks; ++block, p += 64 * Size)
+      if (Consume<Op>(NullMaskAvx2<Size>(p, splat), block, result, out))
+        break;
+    return result;
+  }
+
+  template<std::size_t Size>
+  [[gnu::target("avx512f,avx512bw")]] inline std::uint64_t NullMaskAvx512(const unsigned char* p,
+                                                                          __m512i              pattern) noexcept
+  {
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < Size; ++i) {
+      const __m512i x = _mm512_loadu_si512(p + 64 * i);
+      if constexpr (Size == 1)
+        mask = _mm512_cmpeq_epi8_mask(x, pattern);
+      else if constexpr (Size == 2)
+        mask |= std::uint64_t(_mm512_cmpeq_epi16_mask(x, pattern)) << (32 * i);
+      else if constexpr (Size == 4)
+        mask |= std::uint64_t(_mm512_cmpeq_epi32_mask(x, pattern)) << (16 * i);
+      else
+        mask |= std::uint64_t(_mm512_cmpeq_epi64_mask(x, pattern)) << (8 * i);
+    }
+    return mask;
+  }
+
+  template<std::size_t Size>
+  [[gnu::target("avx512f,avx512bw")]] inline __m512i SplatAvx512(std::uint64_t pattern) noexcept
+  {
+    if constexpr (Size == 1)
+      return _mm512_set1_epi8(static_cast<char>(pattern));
+    else if constexpr (Size == 2)
+      return _mm512_set1_epi16(static_cast<short>(pattern));
+    else if constexpr (Size == 4)
+      return _mm512_set1_epi32(static_cast<int>(pattern));
+    else
+      return _mm512_set1_epi64(static_cast<long long>(pattern));
+  }
+
+  template<Scan Op, std::size_t Size>
+  [[gnu::target("avx512f,avx512bw")]] std::size_t ScanAvx512(const unsigned char* p,
+                                                             std::size_t          blocks,
+                                                             std::uint64_t        pattern,
+                                                             std::uint64_t*       out) noexcept
+  {
+    const __m512i splat  = SplatAvx512<Size>(pattern);
+    std::size_t   result = InitialResult<Op>(blocks);
+    for (std::size_t block = 0; block < blocks; ++block, p += 64 * Size)
+      if (Consume<Op>(NullMaskAvx512<Size>(p, splat), block, result, out))
+        break;
+    return result;
+  }
+
+  template<Scan Op, std::size_t Size>
+  Kernel SelectKernel() noexcept
+  {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+      return &ScanAvx512<Op, Size>;
+    if (__builtin_cpu_supports("avx2"))
+      return &ScanAvx2<Op, Size>;
+    return &ScanSse2<Op, Size>;
+  }
+#else
+  template<std::size_t Size>
+  inline std::uint64_t NullMaskScalar(const unsigned char* p, std::uint64_t pattern) noexcept
+  {
+    using bits_type    = typename tombstone_optional_details::UnsignedOfSize<Size>::type;
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < 64; ++i) {
+      bits_type bits;
+      std::memcpy(&bits, p + i * Size, Size);
+      mask |= std::uint64_t(bits == static_cast<bits_type>(pattern)) << i;
+    }
+    return mask;
+  }
+
+  template<Scan Op, std::size_t Size>
+  std::size_t ScanScalar(const unsigned char* p, std::size_t blocks, std::uint64_t pattern, std::uint64_t* out) noexcept
+  {
+    std::size_t result = InitialResult<Op>(blocks);
+    for (std::size_t block = 0; block < blocks; ++block, p += 64 * Size)
+      if (Consume<Op>(NullMaskScalar<Size>(p, pattern), block, result, out))
+        break;
+    return result;
+  }
+
+  template<Scan Op, std::size_t Size>
+  Kernel SelectKernel() noexcept
+  {
+    return &ScanScalar<Op, Size>;
+  }
+#endif
+
+  template<Scan Op, std::size_t Size>
+  std::size_t RunKernel(const void* p, std::size_t blocks, std::uint64_t pattern, std::uint64_t* out) noexcept
+  {
+    static const Kernel kernel = SelectKernel<Op, Size>();
+    return kernel(static_cast<const unsigned char*>(p), blocks, pattern, out);
+  }
+
+  template<typename R>
+  concept OptionalRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    tombstone_optional_details::TombstoneOptional<std::ranges::range_value_t<R>>;
+
+  // runs `Op` over the whole blocks with a kernel when the null state is a bit pattern,
+  // the remaining elements are handled one at a time
+  template<Scan Op, typename Optional>
+  std::size_t Run(const Optional* first, std::size_t count, std::uint64_t* out) noexcept
+  {
+    using T      = typename Optional::value_type;
+    using Traits = typename Optional::traits_type;
+
+    std::size_t done   = 0;
+    std::size_t result = 0;
+    if constexpr (HasNullPattern<Traits, T> && sizeof(Optional) == sizeof(T)) {
+      constexpr auto pattern = *NullPattern<Traits, T>();
+      const std::size_t blocks = count / 64;
+      result = RunKernel<Op, sizeof(T)>(first, blocks, static_cast<std::uint64_t>(pattern), out);
+      if ((Op == Scan::FirstNull || Op == Scan::FirstPresent) && result != blocks * 64)
+        return result;
+      done = blocks * 64;
+    }
+
+    if constexpr (Op == Scan::Bitmap) {
+      for (std::size_t word = done / 64; done != count; ++word) {
+        const std::size_t last = std::min(count, done + 64);
+        std::uint64_t     bits = 0;
+        for (std::size_t i = done; i < last; ++i)
+          bits |= std::uint64_t(first[i].has_value()) << (i - done);
+        out[word] = bits;
+        done      = last;
+      }
+      return 0;
+    }
+    else {
+      for (std::size_t i = done; i < count; ++i) {
+        const bool present = first[i].has_value();
+        if constexpr (Op == Scan::CountNulls)
+          result += !present;
+        else if (present == (Op == Scan::FirstPresent))
+          return i;
+      }
+      return Op == Scan::CountNulls ? result : count;
+    }
+  }
+} // namespace presence_details
+
+// The functions below take a contiguous range of `tombstone_optional`. When the null state of the traits is a constant
+// bit pattern (`null_is_zero_bits` or a `null_value` of the same size as `T`) and `T` is 1, 2, 4 or 8 bytes they compare
+// 64 elements at a time with SSE2, AVX2 or AVX-512 picked at runtime, other ranges call `has_value()` on each element.
+
+// the number of elements with a value
+template<presence_details::OptionalRange R>
+[[nodiscard]] std::size_t count_present(const R& r) noexcept
+{
+  const std::size_t count = std::ranges::size(r);
+  return count - presence_details::Run<presence_details::Scan::CountNulls>(std::ranges::data(r), count, nullptr);
+}
+
+// the index of the first element with a value, or the size of the range if there is none
+template<presence_details::OptionalRange R>
+[[nodiscard]] std::size_t find_first_present(const R& r) noexcept
+{
+  return presence_details::Run<presence_details::Scan::FirstPresent>(std::ranges::data(r), std::ranges::size(r), nullptr);
+}
+
+// the index of the first null element, or the size of the range if there is none
+template<presence_details::OptionalRange R>
+[[nodiscard]] std::size_t find_first_null(const R& r) noexcept
+{
+  return presence_details::Run<presence_details::Scan::FirstNull>(std::ranges::data(r), std::ranges::size(r), nullptr);
+}
+
+// Sets bit `i % 64` of `out[i / 64]` when element `i` has a value, `out` must hold `(size + 63) / 64` words.
+// The bits past the end of the range are cleared.
+template<presence_details::OptionalRange R>
+void to_presence_bitmap(const R& r, std::uint64_t* out) noexcept
+{
+  presence_details::Run<presence_details::Scan::Bitmap>(std::ranges::data(r), std::ranges::size(r), out);
+}
+
+} // namespace zxshady
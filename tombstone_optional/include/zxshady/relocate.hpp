@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new> // std::launder
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+// Whether moving a `T` to new storage and destroying the old one is the same as copying its bytes (P1144),
+// specialize it for types that are relocatable without being trivially copyable.
+template<typename T>
+struct is_trivially_relocatable
+: std::bool_constant<std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T>> {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<std::remove_cv_t<T>>::value;
+
+template<typename T, typename Deleter>
+struct is_trivially_relocatable<std::unique_ptr<T, Deleter>>
+: std::bool_constant<is_trivially_relocatable_v<Deleter> &&
+                     is_trivially_relocatable_v<typename std::unique_ptr<T, Deleter>::pointer>> {};
+
+template<typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template<typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+// libstdc++ only keeps trivially copyable functors inline, libc++ and MSVC point into their own buffer
+#if defined(__GLIBCXX__)
+template<typename R, typename... Args>
+struct is_trivially_relocatable<std::function<R(Args...)>> : std::true_type {};
+#endif
+
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)
+template<typename T>
+struct is_trivially_relocatable<std::vector<T, std::allocator<T>>> : std::true_type {};
+#endif
+
+// the libstdc++ string points into itself when it is small
+#if defined(_LIBCPP_VERSION)
+template<typename CharT, typename Traits>
+struct is_trivially_relocatable<std::basic_string<CharT, Traits, std::allocator<CharT>>> : std::true_type {};
+#endif
+
+// Traits can declare `static constexpr bool trivially_relocatable = false;` when their null state
+// cannot be moved by copying its bytes, by default the null state is as relocatable as `T`.
+template<typename T, typename Traits>
+struct is_trivially_relocatable<tombstone_optional<T, Traits>>
+: std::bool_constant<is_trivially_relocatable_v<T> && [] {
+    if constexpr (requires { Traits::trivially_relocatable; })
+      return bool{Traits::trivially_relocatable};
+    else
+      return true;
+  }()> {};
+
+template<typename T>
+inline constexpr bool is_nothrow_relocatable_v =
+  is_trivially_relocatable_v<T> || (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>);
+
+// ends the lifetime of `*source` and starts the one of `*dest` with its value
+template<typename T>
+T* relocate_at(T* source, T* dest) noexcept(is_nothrow_relocatable_v<T>)
+{
+  if constexpr (is_trivially_relocatable_v<T>) {
+    std::memmove(static_cast<void*>(dest), static_cast<const void*>(source), sizeof(T));
+    return std::launder(dest);
+  }
+  else {
+    T* const result = std::construct_at(dest, std::move(*source));
+    std::destroy_at(source);
+    return result;
+  }
+}
+
+// Relocates [first, last) into the uninitialized storage at `d_first`, the ranges may overlap when `d_first < first`.
+// If a move constructor throws the relocated elements and the rest of the source, including the one
+// that failed to move, are destroyed.
+template<typename T>
+T* uninitialized_relocate(T* first, T* last, T* d_first) noexcept(is_nothrow_relocatable_v<T>)
+{
+  if constexpr (is_trivially_relocatable_v<T>) {
+    const auto count = static_cast<std::size_t>(last - first);
+    if (count != 0)
+      std::memmove(static_cast<void*>(d_first), static_cast<const void*>(first), count * sizeof(T));
+    return d_first + count;
+  }
+  else if constexpr (is_nothrow_relocatable_v<T>) {
+    for (; first != last; ++first, ++d_first)
+      relocate_at(first, d_first);
+    return d_first;
+  }
+  else {
+    T* d_current = d_first;
+    try {
+      for (; first != last; ++first, ++d_current)
+        relocate_at(first, d_current);
+    }
+    catch (...) {
+      std::destroy(d_first, d_current);
+      std::destroy(first, last);
+      throw;
+    }
+    return d_current;
+  }
+}
+
+// A minimal vector that grows by relocating its elements, so trivially relocatable elements move with `memcpy`
+template<typename T, typename Allocator = std::allocator<T>>
+class relocating_vector {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  static_assert(std::is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+public:
+  using value_type      = T;
+  using allocator_type  = Allocator;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference       = T&;
+  using const_reference = const T&;
+  using pointer         = T*;
+  using const_pointer   = const T*;
+  using iterator        = T*;
+  using const_iterator  = const T*;
+
+  relocating_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+  explicit relocating_vector(const Allocator& alloc) noexcept : mAllocator(alloc) {}
+
+  relocating_vector(std::initializer_list<T> ilist, const Allocator& alloc = Allocator())
+    requires std::is_copy_constructible_v<T>
+  : mAllocator(alloc)
+  {
+    reserve(ilist.size());
+    for (const T& x : ilist)
+      emplace_back(x);
+  }
+
+  relocating_vector(const relocating_vector& that)
+    requires std::is_copy_constructible_v<T>
+  : mAllocator(alloc_traits::select_on_container_copy_construction(that.mAllocator))
+  {
+    reserve(that.size());
+    for (const T& x : that)
+      emplace_back(x);
+  }
+
+  relocating_vector(relocating_vector&& that) noexcept
+  : mAllocator(std::move(that.mAllocator))
+  , mBegin(std::exchange(that.mBegin, nullptr))
+  , mEnd(std::exchange(that.mEnd, nullptr))
+  , mCapacity(std::exchange(that.mCapacity, nullptr))
+  {
+  }
+
+  relocating_vector& operator=(relocating_vector that) noexcept
+  {
+    swap(*this, that);
+    return *this;
+  }
+
+  ~relocating_vector()
+  {
+    clear();
+    Deallocate();
+  }
+
+  [[nodiscard]] iterator       begin() noexcept { return mBegin; }
+  [[nodiscard]] const_iterator begin() const noexcept { return mBegin; }
+  [[nodiscard]] iterator       end() noexcept { return mEnd; }
+  [[nodiscard]] const_iterator end() const noexcept { return mEnd; }
+
+  [[nodiscard]] T*       data() noexcept { return mBegin; }
+  [[nodiscard]] const T* data() const noexcept { return mBegin; }
+
+  [[nodiscard]] size_type size() const noexcept { return static_cast<size_type>(mEnd - mBegin); }
+  [[nodiscard]] size_type capacity() const noexcept { return static_cast<size_type>(mCapacity - mBegin); }
+  [[nodiscard]] bool      empty() const noexcept { return mBegin == mEnd; }
+
+  [[nodiscard]] T& operator[](size_type i) noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(i < size(), "relocating_vector index out of range");
+    return mBegin[i];
+  }
+  [[nodiscard]] const T& operator[](size_type i) const noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(i < size(), "relocating_vector index out of range");
+    return mBegin[i];
+  }
+
+  [[nodiscard]] T&       back() noexcept { return mEnd[-1]; }
+  [[nodiscard]] const T& back() const noexcept { return mEnd[-1]; }
+
+  [[nodiscard]] size_type max_size() const noexcept { return alloc_traits::max_size(mAllocator); }
+
+  void reserve(size_type new_capacity)
+  {
+    if (new_capacity > max_size())
+      throw std::length_error("relocating_vector::reserve larger than max_size");
+    if (new_capacity > capacity())
+      Reallocate(new_capacity);
+  }
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args)
+  {
+    return *append_uninitialized(1, [&](T* slot) { alloc_traits::construct(mAllocator, slot, ZXFWD(args)...); });
+  }
+
+  // Appends `count` elements that `init(first)` constructs in the uninitialized storage at `first` and
+  // returns `first`. `init` runs before the old elements are relocated, so arguments referring to them
+  // stay valid while growing, and it must leave nothing constructed when it throws.
+  template<typename Init>
+  T* append_uninitialized(size_type count, Init init)
+  {
+    if (static_cast<size_type>(mCapacity - mEnd) >= count) {
+      init(mEnd);
+      return std::exchange(mEnd, mEnd + count);
+    }
+    const size_type new_capacity = NextCapacity(count);
+    T* const        storage      = alloc_traits::allocate(mAllocator, new_capacity);
+    T* const        first        = storage + size();
+    try {
+      init(first);
+    }
+    catch (...) {
+      alloc_traits::deallocate(mAllocator, storage, new_capacity);
+      throw;
+    }
+    try {
+      Adopt(storage, new_capacity);
+    }
+    catch (...) {
+      std::destroy(first, first + count);
+      alloc_traits::deallocate(mAllocator, storage, new_capacity);
+      throw;
+    }
+    mEnd += count;
+    return first;
+  }
+
+  void push_back(const T& x) { emplace_back(x); }
+  void push_back(T&& x) { emplace_back(std::move(x)); }
+
+  void pop_back() noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!empty(), "pop_back on an empty relocating_vector");
+    alloc_traits::destroy(mAllocator, --mEnd);
+  }
+
+  void clear() noexcept
+  {
+    std::destroy(mBegin, mEnd);
+    mEnd = mBegin;
+  }
+
+  friend void swap(relocating_vector& a, relocating_vector& b) noexcept
+  {
+    using std::swap;
+    swap(a.mAllocator, b.mAllocator);
+    swap(a.mBegin, b.mBegin);
+    swap(a.mEnd, b.mEnd);
+    swap(a.mCapacity, b.mCapacity);
+  }
+private:
+  // doubles the capacity, or more when `count` elements do not fit in that
+  [[nodiscard]] size_type NextCapacity(size_type count) const
+  {
+    const size_type max = max_size();
+    if (count > max - size())
+      throw std::length_error("relocating_vector is longer than max_size");
+    const size_type doubled = capacity() == 0 ? 4 : capacity() > max / 2 ? max : capacity() * 2;
+    return std::max(size() + count, doubled);
+  }
+
+  void Reallocate(size_type new_capacity)
+  {
+    T* const storage = alloc_traits::allocate(mAllocator, new_capacity);
+    try {
+      Adopt(storage, new_capacity);
+    }
+    catch (...) {
+      alloc_traits::deallocate(mAllocator, storage, new_capacity);
+      throw;
+    }
+  }
+
+  // relocates the elements into `storage` and frees the old buffer, if an element fails to move
+  // the old buffer is left untouched like `std::vector` does
+  void Adopt(T* storage, size_type new_capacity)
+  {
+    const size_type count = size();
+    if constexpr (is_nothrow_relocatable_v<T>) {
+      uninitialized_relocate(mBegin, mEnd, storage);
+    }
+    else {
+      T* current = storage;
+      try {
+        for (T* it = mBegin; it != mEnd; ++it, ++current)
+          alloc_traits::construct(mAllocator, current, std::move_if_noexcept(*it));
+      }
+      catch (...) {
+        std::destroy(storage, current);
+        throw;
+      }
+      std::destroy(mBegin, mEnd);
+    }
+    Deallocate();
+    mBegin    = storage;
+    mEnd      = storage + count;
+    mCapacity = storage + new_capacity;
+  }
+
+  void Deallocate() noexcept
+  {
+    if (mBegin)
+      alloc_traits::deallocate(mAllocator, mBegin, capacity());
+  }
+
+  [[no_unique_address]] Allocator mAllocator{};
+
+  T* mBegin    = nullptr;
+  T* mEnd      = nullptr;
+  T* mCapacity = nullptr;
+};
+
+} // namespace zxshady
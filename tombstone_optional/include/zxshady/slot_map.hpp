@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <zxshady/optional.hpp>
+#include <zxshady/presence.hpp>
+
+namespace zxshady {
+
+// A stable 64 bit reference to a value of a `tombstone_slot_map`
+struct tombstone_slot_handle {
+  std::uint32_t index      = 0;
+  std::uint32_t generation = 0;
+
+  [[nodiscard]] constexpr std::uint64_t bits() const noexcept
+  {
+    return std::uint64_t{generation} << 32 | index;
+  }
+  [[nodiscard]] static constexpr tombstone_slot_handle from_bits(std::uint64_t bits) noexcept
+  {
+    return {static_cast<std::uint32_t>(bits), static_cast<std::uint32_t>(bits >> 32)};
+  }
+
+  [[nodiscard]] friend constexpr bool operator==(tombstone_slot_handle, tombstone_slot_handle) noexcept = default;
+};
+
+// Values in one contiguous array of `tombstone_optional<T, Traits>` found through generational handles.
+// An erased slot becomes the null state and its generation is bumped, so a handle is valid exactly when its
+// generation matches the slot's and there is no live flag. Erased slots are reused last in, first out.
+template<typename T, typename Traits = tombstone_traits<T>>
+class tombstone_slot_map {
+public:
+  using value_type    = T;
+  using traits_type   = Traits;
+  using optional_type = tombstone_optional<T, Traits>;
+  using size_type     = std::size_t;
+  using handle        = tombstone_slot_handle;
+private:
+  template<bool Const>
+  class Iterator {
+    using map_pointer = std::conditional_t<Const, const tombstone_slot_map*, tombstone_slot_map*>;
+  public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::conditional_t<Const, const T&, T&>;
+
+    Iterator() = default;
+    Iterator(map_pointer map, size_type index) noexcept : mMap(map), mIndex(map->NextPresent(index)) {}
+
+    // a mutable iterator converts to a const one
+    operator Iterator<true>() const noexcept
+      requires(!Const)
+    {
+      return {mMap, mIndex};
+    }
+
+    [[nodiscard]] reference operator*() const noexcept { return *mMap->mSlots[mIndex]; }
+    [[nodiscard]] auto      operator->() const noexcept { return std::addressof(**this); }
+
+    // the handle of the current value
+    [[nodiscard]] handle get_handle() const noexcept
+    {
+      return {static_cast<std::uint32_t>(mIndex), mMap->mGenerations[mIndex]};
+    }
+
+    Iterator& operator++() noexcept
+    {
+      mIndex = mMap->NextPresent(mIndex + 1);
+      return *this;
+    }
+    Iterator operator++(int) noexcept
+    {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    [[nodiscard]] friend bool operator==(const Iterator& a, const Iterator& b) noexcept
+    {
+      return a.mIndex == b.mIndex;
+    }
+  private:
+    map_pointer mMap   = nullptr;
+    size_type   mIndex = 0;
+  };
+public:
+  using iterator       = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  tombstone_slot_map() = default;
+
+  [[nodiscard]] iterator       begin() noexcept { return {this, 0}; }
+  [[nodiscard]] const_iterator begin() const noexcept { return {this, 0}; }
+  [[nodiscard]] iterator       end() noexcept { return {this, mSlots.size()}; }
+  [[nodiscard]] const_iterator end() const noexcept { return {this, mSlots.size()}; }
+
+  [[nodiscard]] size_type size() const noexcept { return mSlots.size() - mFree.size(); }
+  [[nodiscard]] bool      empty() const noexcept { return size() == 0; }
+  // the number of slots, live or erased
+  [[nodiscard]] size_type slot_count() const noexcept { return mSlots.size(); }
+
+  void reserve(size_type count)
+  {
+    mSlots.reserve(count);
+    mGenerations.reserve(count);
+  }
+
+  template<typename... Args>
+    requires std::constructible_from<T, Args...>
+  handle emplace(Args&&... args)
+  {
+    if (!mFree.empty()) {
+      const std::uint32_t index = mFree.back();
+      mSlots[index].emplace(ZXFWD(args)...);
+      mFree.pop_back();
+      return {index, mGenerations[index]};
+    }
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(mSlots.size() < UINT32_MAX, "tombstone_slot_map is full");
+    mGenerations.reserve(mSlots.size() + 1);
+    mSlots.emplace_back(std::in_place, ZXFWD(args)...);
+    mGenerations.push_back(0);
+    return {static_cast<std::uint32_t>(mSlots.size() - 1), 0};
+  }
+
+  handle insert(const T& value) { return emplace(value); }
+  handle insert(T&& value) { return emplace(std::move(value)); }
+
+  [[nodiscard]] bool contains(handle h) const noexcept
+  {
+    return h.index < mGenerations.size() && mGenerations[h.index] == h.generation;
+  }
+
+  // the value of `h`, or nullptr when it was erased
+  [[nodiscard]] T* get(handle h) noexcept { return contains(h) ? std::addressof(*mSlots[h.index]) : nullptr; }
+  [[nodiscard]] const T* get(handle h) const noexcept
+  {
+    return contains(h) ? std::addressof(*mSlots[h.index]) : nullptr;
+  }
+
+  [[nodiscard]] T& operator[](handle h) noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(contains(h), "tombstone_slot_map handle is not valid");
+    return *mSlots[h.index];
+  }
+  [[nodiscard]] const T& operator[](handle h) const noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(contains(h), "tombstone_slot_map handle is not valid");
+    return *mSlots[h.index];
+  }
+
+  // destroys the value of `h` and returns whether it was valid
+  bool erase(handle h)
+  {
+    if (!contains(h))
+      return false;
+    mFree.reserve(mSlots.size());
+    Erase(h.index);
+    return true;
+  }
+
+  // the iterator after `pos`
+  iterator erase(const_iterator pos)
+  {
+    const handle h = pos.get_handle();
+    erase(h);
+    return {this, h.index + size_type{1}};
+  }
+
+  // erases every value, the handles to them stay invalid when their slots are reused
+  void clear()
+  {
+    mFree.reserve(mSlots.size());
+    for (size_type i = NextPresent(0); i != mSlots.size(); i = NextPresent(i + 1))
+      Erase(static_cast<std::uint32_t>(i));
+  }
+private:
+  void Erase(std::uint32_t index) noexcept
+  {
+    mSlots[index].reset();
+    // a generation wraps around after 2^32 reuses of the same slot
+    ++mGenerations[index];
+    mFree.push_back(index);
+  }
+
+  // the first slot from `i` with a value, long runs of erased slots are skipped with the presence scans
+  [[nodiscard]] size_type NextPresent(size_type i) const noexcept
+  {
+    if (i >= mSlots.size())
+      return mSlots.size();
+    return i + find_first_present(std::span<const optional_type>(mSlots).subspan(i));
+  }
+
+  std::vector<optional_type> mSlots;
+  std::vector<std::uint32_t> mGenerations;
+  // erased slots, the last one is reused first
+  std::vector<std::uint32_t> mFree;
+};
+
+} // namespace zxshady
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+namespace sort_details {
+  template<typename R>
+  concept OptionalRange = std::ranges::random_access_range<R> &&
+    tombstone_optional_details::TombstoneOptional<std::ranges::range_value_t<R>>;
+
+  template<typename T>
+  concept RadixKey = (std::is_integral_v<T> || std::is_enum_v<T> || std::is_floating_point_v<T>) &&
+    !std::is_same_v<T, bool> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+  template<typename R>
+  concept RadixRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> && OptionalRange<R> &&
+    std::is_trivially_copyable_v<std::ranges::range_value_t<R>> &&
+    RadixKey<typename std::ranges::range_value_t<R>::value_type> &&
+    sizeof(std::ranges::range_value_t<R>) == sizeof(typename std::ranges::range_value_t<R>::value_type);
+
+  // maps the bits of a `T` to an unsigned key with the same order
+  template<typename T>
+  struct Key {
+    using bits_type = typename tombstone_optional_details::UnsignedOfSize<sizeof(T)>::type;
+
+    static constexpr bits_type sign_bit = bits_type{1} << (sizeof(T) * 8 - 1);
+
+    static constexpr bits_type Get(bits_type bits) noexcept
+    {
+      using underlying_type =
+        typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+      if constexpr (std::is_floating_point_v<T>)
+        return (bits & sign_bit) ? static_cast<bits_type>(~bits) : static_cast<bits_type>(bits | sign_bit);
+      else if constexpr (std::is_signed_v<underlying_type>)
+        return static_cast<bits_type>(bits ^ sign_bit);
+      else
+        return bits;
+    }
+  };
+
+  // LSD radix sort of `count` elements of `T` stored at `data`, one byte per pass
+  template<typename T>
+  void RadixSortBits(void* data, std::size_t count)
+  {
+    using key_type  = Key<T>;
+    using bits_type = typename key_type::bits_type;
+    constexpr std::size_t passes = sizeof(T);
+
+    auto       buffer = std::make_unique_for_overwrite<bits_type[]>(2 * count);
+    bits_type* source = buffer.get();
+    bits_type* dest   = source + count;
+    std::memcpy(source, data, count * sizeof(T));
+
+    std::array<std::array<std::size_t, 256>, passes> histograms{};
+    for (std::size_t i = 0; i < count; ++i) {
+      const bits_type key = key_type::Get(source[i]);
+      for (std::size_t pass = 0; pass < passes; ++pass)
+        ++histograms[pass][(key >> (8 * pass)) & 0xff];
+    }
+
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+      auto& histogram = histograms[pass];
+      // every key has the same byte here so the pass would not move anything
+      if (std::ranges::find(histogram, count) != histogram.end())
+        continue;
+
+      std::size_t offset = 0;
+      for (std::size_t& bucket : histogram)
+        offset += std::exchange(bucket, offset);
+      for (std::size_t i = 0; i < count; ++i)
+        dest[histogram[(key_type::Get(source[i]) >> (8 * pass)) & 0xff]++] = source[i];
+      std::swap(source, dest);
+    }
+    std::memcpy(data, source, count * sizeof(T));
+  }
+} // namespace sort_details
+
+// Moves the nulls to the front, the order `operator<` gives them, and returns the values that follow
+template<sort_details::OptionalRange R>
+  requires std::permutable<std::ranges::iterator_t<R>>
+std::ranges::borrowed_subrange_t<R> partition_nulls(R&& r)
+{
+  return std::ranges::partition(r, [](const auto& o) { return !o.has_value(); });
+}
+
+// Sorts a contiguous range of `tombstone_optional` of integers, enums or floating point numbers like
+// `std::ranges::sort` does with nulls first, by radix sorting the stored bits. Traits that declare
+// `null_orders_first` or `null_orders_last` are sorted as plain `T`, the nulls are partitioned out first otherwise.
+template<sort_details::RadixRange R>
+void radix_sort(R&& r)
+{
+  using optional_type = std::ranges::range_value_t<R>;
+  using T             = typename optional_type::value_type;
+  using Traits        = typename optional_type::traits_type;
+
+  auto* const       first = std::ranges::data(r);
+  const std::size_t count = std::ranges::size(r);
+  if (count < 2)
+    return;
+
+  if constexpr (tombstone_optional_details::NullOrdersFirst<Traits>) {
+    sort_details::RadixSortBits<T>(first, count);
+  }
+  else if constexpr (tombstone_optional_details::NullOrdersLast<Traits>) {
+    sort_details::RadixSortBits<T>(first, count);
+    auto* const nulls = std::ranges::find_if(first, first + count, [](const optional_type& o) { return !o; });
+    std::rotate(first, nulls, first + count);
+  }
+  else {
+    const auto  is_null = [](const optional_type& o) { return !o; };
+    auto* const values  = std::ranges::partition(first, first + count, is_null).begin();
+    sort_details::RadixSortBits<T>(values, static_cast<std::size_t>(first + count - values));
+  }
+}
+
+// The first element that is not less than `value` in a range sorted with nulls first, `value` must not be the null state
+template<sort_details::OptionalRange R, typename U>
+[[nodiscard]] std::ranges::borrowed_iterator_t<R> lower_bound_present(R&& r, const U& value)
+{
+  using optional_type = std::ranges::range_value_t<R>;
+  using Traits        = typename optional_type::traits_type;
+
+  if constexpr (tombstone_optional_details::NullOrdersFirst<Traits> &&
+                std::totally_ordered_with<typename optional_type::value_type, U>) {
+    if constexpr (std::is_same_v<U, typename optional_type::value_type>)
+      ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(!Traits::is_null(value), "lower_bound_present of the null state", value);
+    // the null state compares below `value` like a null does
+    const auto project = [](const optional_type& o) -> const auto& {
+      return tombstone_optional_details::Access::Value(o);
+    };
+    return std::ranges::lower_bound(r, value, std::ranges::less{}, project);
+  }
+  else {
+    const auto values  = std::ranges::partition_point(r, [](const optional_type& o) { return !o.has_value(); });
+    const auto project = [](const optional_type& o) -> const auto& { return *o; };
+    return std::ranges::lower_bound(values, std::ranges::end(r), value, std::ranges::less{}, project);
+  }
+}
+
+} // namespace zxshady
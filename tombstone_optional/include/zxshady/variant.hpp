@@ -0,0 +1,387 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant> // std::bad_variant_access std::in_place_type_t
+#include <zxshady/optional.hpp>
+
+namespace zxshady {
+
+namespace tombstone_variant_details {
+  template<typename U, typename... Ts>
+  inline constexpr std::size_t index_of = [] {
+    constexpr bool matches[] = {std::is_same_v<U, Ts>...};
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+      if (matches[i])
+        return i;
+    return sizeof...(Ts);
+  }();
+
+  template<typename... Ts>
+  inline constexpr bool unique = [] {
+    constexpr std::size_t indices[] = {index_of<Ts, Ts...>...};
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+      if (indices[i] != i)
+        return false;
+    return true;
+  }();
+} // namespace tombstone_variant_details
+
+// Holds either a `T` or one of the stateless `Empties`, the k-th empty alternative is stored
+// as niche k of `Traits` so the variant is as large as `T`.
+// Alternative 0 is `T` and alternative k + 1 is the k-th empty one.
+template<typename T, typename Traits, typename... Empties>
+class basic_tombstone_variant {
+  static_assert(sizeof...(Empties) >= 1, "a tombstone_variant needs at least one empty alternative");
+  static_assert(((std::is_empty_v<Empties> && std::is_nothrow_default_constructible_v<Empties>) && ...),
+                "Empties must be empty and nothrow default constructible");
+  static_assert(tombstone_variant_details::unique<std::remove_cv_t<T>, Empties...>,
+                "the alternatives must be distinct types");
+  static_assert(std::is_nothrow_destructible_v<T>, "T must be no throw destructible");
+  static_assert(concepts::tombstone_trivial_destroy_traits_for<Traits, T>,
+                "Traits must not define destroy_null_state, the niches are not objects");
+  static_assert(tombstone_niche_count_v<Traits, T> >= sizeof...(Empties),
+                "Traits does not have a niche for every empty alternative");
+
+  static constexpr std::size_t empty_count = sizeof...(Empties);
+
+  template<typename U>
+  static constexpr std::size_t empty_index = tombstone_variant_details::index_of<U, Empties...>;
+public:
+  using value_type  = T;
+  using traits_type = Traits;
+
+  static constexpr std::size_t alternatives = 1 + empty_count;
+
+  // holds the first empty alternative
+  constexpr basic_tombstone_variant() noexcept { tombstone_optional_details::InitializeNiche<Traits>(mValue, 0); }
+
+  template<typename E>
+    requires(empty_index<std::remove_cvref_t<E>> < empty_count)
+  constexpr basic_tombstone_variant(E&&) noexcept
+  {
+    tombstone_optional_details::InitializeNiche<Traits>(mValue, empty_index<std::remove_cvref_t<E>>);
+  }
+
+  template<typename U = std::remove_cv_t<T>>
+    requires std::constructible_from<T, U> && (empty_index<std::remove_cvref_t<U>> == empty_count) &&
+    (!std::same_as<std::remove_cvref_t<U>, basic_tombstone_variant>)
+  explicit(!std::is_convertible_v<U, T>) constexpr basic_tombstone_variant(U&& u) noexcept(
+    std::is_nothrow_constructible_v<T, U>)
+  : mValue(ZXFWD(u))
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "\"u\" cannot be a niche of `zxshady::tombstone_variant`", mValue);
+  }
+
+  template<typename... Args>
+    requires std::constructible_from<T, Args...>
+  explicit constexpr basic_tombstone_variant(std::in_place_type_t<T>, Args&&... args) noexcept(
+    std::is_nothrow_constructible_v<T, Args...>)
+  : mValue(ZXFWD(args)...)
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "T(args...) cannot be a niche of `zxshady::tombstone_variant`", mValue);
+  }
+
+  constexpr basic_tombstone_variant(const basic_tombstone_variant&)
+    requires tombstone_optional_details::TriviallyCopyConstructible<T>
+  = default;
+  constexpr basic_tombstone_variant(basic_tombstone_variant&&)
+    requires tombstone_optional_details::TriviallyMoveConstructible<T>
+  = default;
+  constexpr basic_tombstone_variant& operator=(const basic_tombstone_variant&)
+    requires tombstone_optional_details::TriviallyCopyAssignable<T> &&
+    tombstone_optional_details::TriviallyCopyConstructible<T>
+  = default;
+  constexpr basic_tombstone_variant& operator=(basic_tombstone_variant&&)
+    requires tombstone_optional_details::TriviallyMoveAssignable<T> &&
+    tombstone_optional_details::TriviallyMoveConstructible<T>
+  = default;
+  constexpr ~basic_tombstone_variant()
+    requires std::is_trivially_destructible_v<T>
+  = default;
+
+  constexpr basic_tombstone_variant(const basic_tombstone_variant& that) noexcept(std::is_nothrow_copy_constructible_v<T>)
+    requires tombstone_optional_details::CopyConstructible<T>
+  {
+    if (that.holds_value())
+      std::construct_at(std::addressof(mValue), that.mValue);
+    else
+      tombstone_optional_details::InitializeNiche<Traits>(mValue, that.NicheIndex());
+  }
+
+  constexpr basic_tombstone_variant(basic_tombstone_variant&& that) noexcept(std::is_nothrow_move_constructible_v<T>)
+    requires tombstone_optional_details::MoveConstructible<T>
+  {
+    if (that.holds_value())
+      std::construct_at(std::addressof(mValue), std::move(that.mValue));
+    else
+      tombstone_optional_details::InitializeNiche<Traits>(mValue, that.NicheIndex());
+  }
+
+  constexpr basic_tombstone_variant& operator=(const basic_tombstone_variant& that) noexcept(
+    std::is_nothrow_copy_assignable_v<T> && std::is_nothrow_copy_constructible_v<T>)
+    requires tombstone_optional_details::CopyAssignable<T> && tombstone_optional_details::CopyConstructible<T>
+  {
+    if (that.holds_value())
+      Assign(that.mValue);
+    else
+      SetNiche(that.NicheIndex());
+    return *this;
+  }
+
+  constexpr basic_tombstone_variant& operator=(basic_tombstone_variant&& that) noexcept(
+    std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>)
+    requires tombstone_optional_details::MoveAssignable<T> && tombstone_optional_details::MoveConstructible<T>
+  {
+    if (that.holds_value())
+      Assign(std::move(that.mValue));
+    else
+      SetNiche(that.NicheIndex());
+    return *this;
+  }
+
+  template<typename E>
+    requires(empty_index<std::remove_cvref_t<E>> < empty_count)
+  constexpr basic_tombstone_variant& operator=(E&&) noexcept
+  {
+    SetNiche(empty_index<std::remove_cvref_t<E>>);
+    return *this;
+  }
+
+  template<typename U = std::remove_cv_t<T>>
+    requires std::constructible_from<T, U> && std::is_assignable_v<T&, U> &&
+    (empty_index<std::remove_cvref_t<U>> == empty_count) && (!std::same_as<std::remove_cvref_t<U>, basic_tombstone_variant>)
+  constexpr basic_tombstone_variant& operator=(U&& u) noexcept(std::is_nothrow_assignable_v<T&, U> &&
+                                                              std::is_nothrow_constructible_v<T, U>)
+  {
+    Assign(ZXFWD(u));
+    return *this;
+  }
+
+  constexpr ~basic_tombstone_variant() noexcept
+  {
+    if (holds_value())
+      mValue.~T();
+  }
+
+  template<typename U, typename... Args>
+    requires std::same_as<U, T> && std::constructible_from<T, Args...>
+  constexpr T& emplace(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+  {
+    if (holds_value())
+      mValue.~T();
+    std::construct_at(std::addressof(mValue), ZXFWD(args)...);
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "Setting a niche in emplace", mValue);
+    return mValue;
+  }
+
+  template<typename E>
+    requires(empty_index<E> < empty_count)
+  constexpr void emplace() noexcept
+  {
+    SetNiche(empty_index<E>);
+  }
+
+  [[nodiscard]] constexpr std::size_t index() const noexcept
+  {
+    const std::size_t niche = NicheIndex();
+    return niche < empty_count ? niche + 1 : 0;
+  }
+
+  template<typename U>
+  [[nodiscard]] constexpr bool holds_alternative() const noexcept
+  {
+    if constexpr (std::is_same_v<U, T>)
+      return holds_value();
+    else {
+      static_assert(empty_index<U> < empty_count, "U is not an alternative of this tombstone_variant");
+      return NicheIndex() == empty_index<U>;
+    }
+  }
+
+  [[nodiscard]] constexpr bool holds_value() const noexcept { return NicheIndex() >= empty_count; }
+
+  [[nodiscard]] constexpr T& operator*() & noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "Calling operator* on an empty alternative!");
+    return mValue;
+  }
+  [[nodiscard]] constexpr const T& operator*() const& noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "Calling operator* on an empty alternative!");
+    return mValue;
+  }
+  [[nodiscard]] constexpr T&& operator*() && noexcept
+  {
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "Calling operator* on an empty alternative!");
+    return static_cast<T&&>(mValue);
+  }
+
+  [[nodiscard]] constexpr T*       operator->() noexcept { return std::addressof(**this); }
+  [[nodiscard]] constexpr const T* operator->() const noexcept { return std::addressof(**this); }
+
+  [[nodiscard]] constexpr T& value() &
+  {
+    if (!holds_value())
+      throw std::bad_variant_access();
+    return mValue;
+  }
+  [[nodiscard]] constexpr const T& value() const&
+  {
+    if (!holds_value())
+      throw std::bad_variant_access();
+    return mValue;
+  }
+  [[nodiscard]] constexpr T&& value() &&
+  {
+    if (!holds_value())
+      throw std::bad_variant_access();
+    return static_cast<T&&>(mValue);
+  }
+
+  [[nodiscard]] constexpr T*       get_if() noexcept { return holds_value() ? std::addressof(mValue) : nullptr; }
+  [[nodiscard]] constexpr const T* get_if() const noexcept { return holds_value() ? std::addressof(mValue) : nullptr; }
+
+  // `f` is called with `T&` or with an lvalue of the empty alternative, every call must return the same type
+  template<typename F>
+  constexpr decltype(auto) visit(F&& f) &
+  {
+    return Visit(*this, ZXFWD(f));
+  }
+  template<typename F>
+  constexpr decltype(auto) visit(F&& f) const&
+  {
+    return Visit(*this, ZXFWD(f));
+  }
+  template<typename F>
+  constexpr decltype(auto) visit(F&& f) &&
+  {
+    return Visit(std::move(*this), ZXFWD(f));
+  }
+
+  [[nodiscard]] friend constexpr bool operator==(const basic_tombstone_variant& a,
+                                                 const basic_tombstone_variant& b) noexcept(noexcept(*a == *b))
+    requires std::equality_comparable<T>
+  {
+    const std::size_t index = a.index();
+    return index == b.index() && (index != 0 || *a == *b);
+  }
+
+  constexpr friend void swap(basic_tombstone_variant& a, basic_tombstone_variant& b) noexcept(
+    std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>)
+  {
+    // no temporary variant, its storage would only be initialized on one branch
+    if (a.holds_value() && b.holds_value()) {
+      using std::swap;
+      swap(a.mValue, b.mValue);
+    }
+    else if (a.holds_value())
+      a.MoveValueInto(b);
+    else if (b.holds_value())
+      b.MoveValueInto(a);
+    else {
+      const std::size_t a_niche = a.NicheIndex();
+      tombstone_optional_details::InitializeNiche<Traits>(a.mValue, b.NicheIndex());
+      tombstone_optional_details::InitializeNiche<Traits>(b.mValue, a_niche);
+    }
+  }
+private:
+  // `*this` holds a value and `that` an empty alternative, they trade places
+  constexpr void MoveValueInto(basic_tombstone_variant& that) noexcept(std::is_nothrow_move_constructible_v<T>)
+  {
+    const std::size_t niche = that.NicheIndex();
+    if constexpr (std::is_nothrow_move_constructible_v<T>)
+      std::construct_at(std::addressof(that.mValue), std::move(mValue));
+    else {
+      try {
+        std::construct_at(std::addressof(that.mValue), std::move(mValue));
+      }
+      catch (...) {
+        tombstone_optional_details::InitializeNiche<Traits>(that.mValue, niche);
+        throw;
+      }
+    }
+    SetNiche(niche);
+  }
+
+  [[nodiscard]] constexpr std::size_t NicheIndex() const noexcept
+  {
+    return tombstone_optional_details::NicheIndex<Traits>(mValue);
+  }
+
+  constexpr void SetNiche(std::size_t index) noexcept
+  {
+    if (holds_value())
+      mValue.~T();
+    tombstone_optional_details::InitializeNiche<Traits>(mValue, index);
+  }
+
+  template<typename U>
+  constexpr void Assign(U&& u) noexcept(std::is_nothrow_assignable_v<T&, U> && std::is_nothrow_constructible_v<T, U>)
+  {
+    if (holds_value())
+      mValue = ZXFWD(u);
+    else
+      std::construct_at(std::addressof(mValue), ZXFWD(u));
+    ZXSHADY_OPTIONAL_TOMBSTONE_ASSERT(holds_value(), "Cannot assign a niche to a tombstone_variant!", mValue);
+  }
+
+  template<typename Self, typename F>
+  static constexpr decltype(auto) Visit(Self&& self, F&& f)
+  {
+    const std::size_t niche = self.NicheIndex();
+    if (niche >= empty_count)
+      return ZXFWD(f)(ZXFWD(self).mValue);
+    return VisitEmpty<0>(f, niche);
+  }
+
+  // a chain of compares against constants, the last alternative needs none
+  template<std::size_t I, typename F>
+  static constexpr decltype(auto) VisitEmpty(F& f, [[maybe_unused]] std::size_t niche)
+  {
+    if constexpr (I + 1 == empty_count) {
+      std::tuple_element_t<I, std::tuple<Empties...>> empty{};
+      return static_cast<F&&>(f)(empty);
+    }
+    else {
+      if (niche == I) {
+        std::tuple_element_t<I, std::tuple<Empties...>> empty{};
+        return static_cast<F&&>(f)(empty);
+      }
+      return VisitEmpty<I + 1>(f, niche);
+    }
+  }
+
+  union {
+    std::remove_cv_t<T> mValue;
+  };
+};
+
+template<typename T, typename... Empties>
+using tombstone_variant = basic_tombstone_variant<T, tombstone_traits<T>, Empties...>;
+
+template<typename F, typename T, typename Traits, typename... Empties>
+constexpr decltype(auto) visit(F&& f, basic_tombstone_variant<T, Traits, Empties...>& v)
+{
+  return v.visit(ZXFWD(f));
+}
+template<typename F, typename T, typename Traits, typename... Empties>
+constexpr decltype(auto) visit(F&& f, const basic_tombstone_variant<T, Traits, Empties...>& v)
+{
+  return v.visit(ZXFWD(f));
+}
+template<typename F, typename T, typename Traits, typename... Empties>
+constexpr decltype(auto) visit(F&& f, basic_tombstone_variant<T, Traits, Empties...>&& v)
+{
+  return std::move(v).visit(ZXFWD(f));
+}
+
+template<typename U, typename T, typename Traits, typename... Empties>
+[[nodiscard]] constexpr bool holds_alternative(const basic_tombstone_variant<T, Traits, Empties...>& v) noexcept
+{
+  return v.template holds_alternative<U>();
+}
+
+} // namespace zxshady
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <zxshady/optional.hpp>
+#include <zxshady/presence.hpp>
+
+namespace zxshady {
+
+namespace views_details {
+  template<typename R>
+  concept OptionalLvalueRange = std::ranges::forward_range<R> &&
+    tombstone_optional_details::TombstoneOptional<std::ranges::range_value_t<R>> &&
+    std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>;
+
+  // A null state that is a plain `T` can be selected with a conditional move instead of a branch,
+  // `bool` is excluded since its null byte is not a valid `bool`.
+  template<typename T>
+  concept BranchlessSelect = std::is_scalar_v<T> && !std::is_same_v<T, bool>;
+
+  // An optional that is emptied instead of copied or moved like the standard's non-propagating-cache,
+  // a cached iterator into an owning view would point into the view it was copied from.
+  template<typename T>
+  class NonPropagatingCache : public std::optional<T> {
+  public:
+    NonPropagatingCache() = default;
+    NonPropagatingCache(const NonPropagatingCache&) noexcept {}
+    NonPropagatingCache(NonPropagatingCache&& that) noexcept { that.reset(); }
+
+    NonPropagatingCache& operator=(const NonPropagatingCache& that) noexcept
+    {
+      if (this != std::addressof(that))
+        this->reset();
+      return *this;
+    }
+    NonPropagatingCache& operator=(NonPropagatingCache&& that) noexcept
+    {
+      this->reset();
+      that.reset();
+      return *this;
+    }
+  };
+} // namespace views_details
+
+// the values of a range of `tombstone_optional`, nulls are skipped
+template<std::ranges::view V>
+  requires views_details::OptionalLvalueRange<V>
+class present_view : public std::ranges::view_interface<present_view<V>> {
+  using base_iterator = std::ranges::iterator_t<V>;
+  using base_sentinel = std::ranges::sentinel_t<V>;
+  using optional_type = std::remove_reference_t<std::ranges::range_reference_t<V>>;
+
+  class Iterator {
+  public:
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::forward_iterator_tag;
+    using reference         = decltype(*std::declval<optional_type&>());
+    using value_type        = std::remove_cvref_t<reference>;
+    using difference_type   = std::ranges::range_difference_t<V>;
+
+    Iterator() = default;
+    Iterator(base_iterator current, base_sentinel last) : mCurrent(std::move(current)), mLast(std::move(last))
+    {
+      SkipNulls();
+    }
+
+    [[nodiscard]] reference operator*() const noexcept { return **mCurrent; }
+    [[nodiscard]] auto      operator->() const noexcept { return std::addressof(**mCurrent); }
+
+    [[nodiscard]] const base_iterator& base() const& noexcept { return mCurrent; }
+
+    Iterator& operator++()
+    {
+      ++mCurrent;
+      SkipNulls();
+      return *this;
+    }
+    Iterator operator++(int)
+    {
+      Iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    [[nodiscard]] friend bool operator==(const Iterator& a, const Iterator& b) { return a.mCurrent == b.mCurrent; }
+    [[nodiscard]] friend bool operator==(const Iterator& a, std::default_sentinel_t) { return a.mCurrent == a.mLast; }
+  private:
+    void SkipNulls()
+    {
+      if (mCurrent == mLast || mCurrent->has_value())
+        return;
+      // long runs of nulls are skipped with the presence kernels
+      if constexpr (std::ranges::contiguous_range<V> && std::sized_sentinel_for<base_sentinel, base_iterator>) {
+        const auto                           size = static_cast<std::size_t>(mLast - mCurrent);
+        const std::span<const optional_type> rest(std::to_address(mCurrent), size);
+        mCurrent += static_cast<difference_type>(find_first_present(rest));
+      }
+      else {
+        do
+          ++mCurrent;
+        while (mCurrent != mLast && !mCurrent->has_value());
+      }
+    }
+
+    base_iterator mCurrent{};
+    base_sentinel mLast{};
+  };
+public:
+  present_view()
+    requires std::default_initializable<V>
+  = default;
+  constexpr explicit present_view(V base) : mBase(std::move(base)) {}
+
+  [[nodiscard]] constexpr V base() const&
+    requires std::copy_constructible<V>
+  {
+    return mBase;
+  }
+  [[nodiscard]] constexpr V base() && { return std::move(mBase); }
+
+  // the first value is found once and cached like `std::ranges::filter_view` does
+  [[nodiscard]] Iterator begin()
+  {
+    if (!mBegin)
+      mBegin.emplace(std::ranges::begin(mBase), std::ranges::end(mBase));
+    return *mBegin;
+  }
+  [[nodiscard]] std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+private:
+  V                                         mBase = V();
+  views_details::NonPropagatingCache<Iterator> mBegin;
+};
+
+template<typename R>
+present_view(R&&) -> present_view<std::views::all_t<R>>;
+
+namespace views_details {
+  struct PresentFn {
+    template<std::ranges::viewable_range R>
+      requires OptionalLvalueRange<R>
+    [[nodiscard]] auto operator()(R&& r) const
+    {
+      return present_view(std::views::all(ZXFWD(r)));
+    }
+
+    template<std::ranges::viewable_range R>
+      requires OptionalLvalueRange<R>
+    [[nodiscard]] friend auto operator|(R&& r, const PresentFn& self)
+    {
+      return self(ZXFWD(r));
+    }
+  };
+
+  template<typename U>
+  struct ValueOr {
+    U mDefault;
+
+    template<typename T, typename Traits>
+    [[nodiscard]] constexpr T operator()(const tombstone_optional<T, Traits>& o) const
+    {
+      if constexpr (BranchlessSelect<T>) {
+        // both sides are plain loads so this becomes a cmov or a blend when vectorized
+        const T raw      = tombstone_optional_details::Access::Value(o);
+        const T fallback = static_cast<T>(mDefault);
+        return o.has_value() ? raw : fallback;
+      }
+      else {
+        return o.has_value() ? *o : static_cast<T>(mDefault);
+      }
+    }
+  };
+
+  template<typename U>
+  struct ValuesOrFn {
+    U mDefault;
+
+    template<std::ranges::viewable_range R>
+      requires OptionalLvalueRange<R>
+    [[nodiscard]] auto operator()(R&& r) const
+    {
+      return std::views::transform(ZXFWD(r), ValueOr<U>{mDefault});
+    }
+
+    template<std::ranges::viewable_range R>
+      requires OptionalLvalueRange<R>
+    [[nodiscard]] friend auto operator|(R&& r, const ValuesOrFn& self)
+    {
+      return self(ZXFWD(r));
+    }
+  };
+} // namespace views_details
+
+namespace views {
+  // `r | views::present` yields a `T&` for every element of `r` that has a value
+  inline constexpr views_details::PresentFn present{};
+
+  // `r | views::values_or(x)` yields every value of `r` with `x` in place of the nulls
+  template<typename U>
+  [[nodiscard]] constexpr views_details::ValuesOrFn<std::decay_t<U>> values_or(U&& default_value)
+  {
+    return {ZXFWD(default_value)};
+  }
+} // namespace views
+
+} // namespace zxshady